@@ -48,7 +48,7 @@ observe_result pyObserve(kernel_builder<> &kernel, spin_op &spin_operator,
         [&](std::size_t i, spin_op &op) {
           return pyObserveAsync(kernel, op, args, i, shots);
         },
-        spin_operator, nQpus);
+        spin_operator, nQpus, shots);
 
   // Launch the observation task
   return details::runObservation(
@@ -42,12 +42,47 @@ state pyGetState(kernel_builder<> &kernel, py::args args) {
       [&]() mutable { kernel.jitAndInvoke(argData.data()); });
 }
 
+/// @brief Run `cudaq::get_amplitudes` on the provided kernel.
+std::vector<complex> pyGetAmplitudes(kernel_builder<> &kernel,
+                                     const std::vector<std::string> &bitStrings,
+                                     py::args args) {
+  auto validatedArgs = validateInputArguments(kernel, args);
+  kernel.jitCode();
+  OpaqueArguments argData;
+  packArgs(argData, validatedArgs);
+  return get_amplitudes([&]() mutable { kernel.jitAndInvoke(argData.data()); },
+                        bitStrings);
+}
+
+/// @brief Run `cudaq::get_probabilities` on the provided kernel.
+std::vector<double> pyGetProbabilities(kernel_builder<> &kernel,
+                                       const std::vector<std::size_t> &qubits,
+                                       py::args args) {
+  auto validatedArgs = validateInputArguments(kernel, args);
+  kernel.jitCode();
+  OpaqueArguments argData;
+  packArgs(argData, validatedArgs);
+  return get_probabilities(
+      [&]() mutable { kernel.jitAndInvoke(argData.data()); }, qubits);
+}
+
 /// @brief Bind the get_state cudaq function
 void bindPyState(py::module &mod) {
 
-  py::class_<state>(mod, "State",
+  py::class_<state>(mod, "State", py::buffer_protocol(),
                     "A representation of the internal simulation quantum state "
                     "vector or density matrix.")
+      .def_buffer([](state &self) -> py::buffer_info {
+        // Expose the state data to numpy without a copy.
+        auto &shape = self.get_shape();
+        std::vector<py::ssize_t> extents(shape.begin(), shape.end());
+        std::vector<py::ssize_t> strides(shape.size(), sizeof(complex));
+        if (shape.size() == 2)
+          strides[0] = shape[1] * sizeof(complex);
+        return py::buffer_info(self.get_data(), sizeof(complex),
+                               py::format_descriptor<complex>::format(),
+                               shape.size(), extents, strides);
+      })
       .def(py::init([](const py::buffer &b) {
              py::buffer_info info = b.request();
              std::vector<std::size_t> shape;
@@ -104,7 +139,12 @@ void bindPyState(py::module &mod) {
             state ss(t);
             return s.overlap(ss);
           },
-          "Compute the overlap of this state with the other one.");
+          "Compute the overlap of this state with the other one.")
+      .def("save", &state::save, py::arg("filename"),
+           "Write the state to the given file.")
+      .def_static("load", &state::load, py::arg("filename"),
+                  "Return the state saved in the given file, memory mapped "
+                  "without a copy.");
 
   mod.def(
       "get_state",
@@ -112,6 +152,23 @@ void bindPyState(py::module &mod) {
         return pyGetState(kernel, args);
       },
       "Return the state generated by the given quantum kernel.");
+
+  mod.def(
+      "get_amplitudes",
+      [](kernel_builder<> &kernel, const std::vector<std::string> &bitStrings,
+         py::args args) { return pyGetAmplitudes(kernel, bitStrings, args); },
+      "Return the amplitudes of the given basis states (one 0 or 1 per qubit, "
+      "qubit 0 first) in the state generated by the given quantum kernel, "
+      "without copying the state.");
+
+  mod.def(
+      "get_probabilities",
+      [](kernel_builder<> &kernel, const std::vector<std::size_t> &qubits,
+         py::args args) { return pyGetProbabilities(kernel, qubits, args); },
+      "Return the probability of each outcome of measuring the given qubits "
+      "(all qubits if empty) in the state generated by the given quantum "
+      "kernel. The first qubit is the most significant bit of the outcome "
+      "index.");
 }
 
 } // namespace cudaq
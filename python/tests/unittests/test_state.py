@@ -112,6 +112,23 @@ def test_simple_density_matrix():
     cudaq.set_qpu('qpp')
 
 
+def test_density_matrix_layout():
+    cudaq.set_qpu('dm')
+
+    # (|0> + i|1>) / sqrt(2) has rho[0, 1] = -i / 2, rho[1, 0] = i / 2.
+    circuit = cudaq.make_kernel()
+    q = circuit.qalloc()
+    circuit.h(q)
+    circuit.s(q)
+
+    state = cudaq.get_state(circuit)
+    rho = np.array(state, copy=False)
+    assert_close(-.5, state[0, 1].imag)
+    assert_close(-.5, rho[0, 1].imag)
+    assert_close(.5, rho[1, 0].imag)
+    cudaq.set_qpu('qpp')
+
+
 # leave for gdb debugging
 if __name__ == "__main__":
     loc = os.path.abspath(__file__)
@@ -10,6 +10,7 @@
 #include "common/PluginUtils.h"
 #include "cudaq/platform.h"
 #include "nvqir/CircuitSimulator.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <pybind11/pybind11.h>
@@ -237,7 +238,10 @@ void LinkedLibraryHolder::setPlatform(
         dlopen(potentialPath.string().c_str(), RTLD_GLOBAL | RTLD_NOW));
 
     // Extract the desired quantum_platform subtype and set it on the runtime.
+    // Platform names may contain dashes, e.g. mqpu-cpu, their symbols use
+    // underscores.
     std::string symbolName = fmt::format("getQuantumPlatform_{}", mutableName);
+    std::replace(symbolName.begin(), symbolName.end(), '-', '_');
     auto *platform =
         getUniquePluginInstance<cudaq::quantum_platform>(symbolName);
     setQuantumPlatformInternal(platform);
@@ -11,6 +11,7 @@
 #include "Future.h"
 #include "MeasureCounts.h"
 #include "NoiseModel.h"
+#include <memory>
 #include <optional>
 #include <string_view>
 
@@ -22,6 +23,13 @@ class spin_op;
 using State =
     std::tuple<std::vector<std::size_t>, std::vector<std::complex<double>>>;
 
+// A StateHandle is the array shape (n,n) or (n) and a pointer to the data of
+// the density matrix or state vector that shares the ownership of the memory
+// it points into (see the std::shared_ptr aliasing constructor), so that the
+// data can be handed over without a copy.
+using StateHandle =
+    std::pair<std::vector<std::size_t>, std::shared_ptr<std::complex<double>>>;
+
 /// @brief The ExecutionContext is an abstraction to indicate
 /// how a CUDA Quantum kernel should be executed.
 class ExecutionContext {
@@ -65,9 +73,53 @@ public:
   /// simulation clients to extract the underlying simulation data.
   State simulationData;
 
+  /// @brief simulationDataHandle is set instead of simulationData when the
+  /// simulator hands its own memory over to the client, without a copy.
+  StateHandle simulationDataHandle;
+
+  /// @brief The basis states whose amplitudes are requested by an
+  /// "extract-amplitudes" context, one character per qubit, qubit 0 first.
+  std::vector<std::string> amplitudeBitStrings;
+
+  /// @brief The amplitudes of the amplitudeBitStrings basis states.
+  std::vector<std::complex<double>> amplitudes;
+
+  /// @brief The qubits whose marginal probabilities are requested by an
+  /// "extract-probabilities" context, all qubits if empty.
+  std::vector<std::size_t> probabilityQubits;
+
+  /// @brief The probability of each outcome of the probabilityQubits, the
+  /// first qubit is the most significant bit of the outcome index.
+  std::vector<double> probabilities;
+
   /// @brief The name of the kernel being executed.
   std::string kernelName = "";
 
+  /// @brief The number of parameter sets of a batched observe task
+  /// ("observe-batch" or "observe-gradient" context). The kernel is invoked
+  /// once per set, and the simulator records the gates of each invocation
+  /// to simulate them all together when the context is reset.
+  std::size_t batchSize = 0;
+
+  /// @brief The index of the parameter set the kernel is invoked with, for
+  /// a batched observe task.
+  std::size_t batchIndex = 0;
+
+  /// @brief The expectation value of each parameter set of a batched
+  /// observe task.
+  std::vector<double> batchExpectationValues;
+
+  /// @brief The parameters of the recorded gates of each kernel invocation
+  /// of an "observe-gradient" task, in the order they were applied. Only
+  /// set if all invocations applied the same gates on the same qubits.
+  std::vector<std::vector<double>> batchGateParameters;
+
+  /// @brief The derivative of the expectation value of the first kernel
+  /// invocation of an "observe-gradient" task with respect to each of its
+  /// gate parameters, see batchGateParameters. The expectation value itself
+  /// is stored in expectationValue.
+  std::vector<double> gateParameterGradients;
+
   /// @brief The Constructor, takes the name of the context
   /// @param n The name of the context
   ExecutionContext(const std::string n) : name(n) {}
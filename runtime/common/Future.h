@@ -119,18 +119,17 @@ public:
         throw std::runtime_error(
             "Returning an observe_result requires a spin_op.");
 
-      // this assumes we ran in shots mode.
+      // this assumes we ran in shots mode, with one measurement
+      // circuit per group of qubit-wise commuting terms.
+      data = details::expandMeasurementGroups(*spinOp, data);
       double sum = 0.0;
-      for (std::size_t i = 0; i < spinOp->n_terms(); i++) {
-        auto term = (*spinOp)[i];
-        if (term.is_identity()) {
-          sum += term.get_coefficients()[0].real();
-          continue;
-        }
-
-        sum += data.exp_val_z(term.to_string(false)) *
-               term.get_coefficients()[0].real();
-      }
+      spinOp->for_each_term_view([&](const spin_op::term_view &term) {
+        auto coeff = term.get_coefficient().real();
+        if (term.is_identity())
+          sum += coeff;
+        else
+          sum += data.exp_val_z(term.to_string()) * coeff;
+      });
 
       return observe_result(sum, *spinOp, data);
     }
@@ -356,10 +356,9 @@ double sample_result::exp_val_z(const std::string_view registerName) {
   if (iter->second.expectationValue.has_value())
     return iter->second.expectationValue.value();
 
-  auto counts = iter->second.counts;
-  for (auto &kv : counts) {
+  for (auto &kv : iter->second.counts) {
     auto par = has_even_parity(kv.first);
-    auto p = probability(kv.first, registerName);
+    auto p = (double)kv.second / totalShots;
     if (!par) {
       p = -p;
     }
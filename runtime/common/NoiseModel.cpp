@@ -9,6 +9,7 @@
 #include "NoiseModel.h"
 #include "Logger.h"
 #include <Eigen/Dense>
+#include <atomic>
 
 namespace cudaq {
 
@@ -87,6 +88,11 @@ kraus_channel &kraus_channel::operator=(const kraus_channel &other) {
 std::vector<kraus_op> kraus_channel::get_ops() { return ops; }
 void kraus_channel::push_back(kraus_op op) { ops.push_back(op); }
 
+std::size_t noise_model::nextVersion() {
+  static std::atomic<std::size_t> counter = 0;
+  return ++counter;
+}
+
 void noise_model::add_channel(const std::string &quantumOp,
                               const std::vector<std::size_t> &qubits,
                               const kraus_channel &channel) {
@@ -106,6 +112,7 @@ void noise_model::add_channel(const std::string &quantumOp,
         std::to_string(channelDim) + " on " + std::to_string(nQubits) +
         " qubits.");
 
+  version = nextVersion();
   auto key = std::make_pair(quantumOp, qubits);
   auto iter = noiseModel.find(key);
   if (iter == noiseModel.end()) {
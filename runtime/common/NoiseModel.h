@@ -166,10 +166,22 @@ protected:
   // names to a kraus channel applied after the operation is applied.
   NoiseModelOpMap noiseModel;
 
+  /// @brief Return a new, process-wide unique, version number.
+  static std::size_t nextVersion();
+
+  /// @brief The version of the contents of this noise model. It is unique
+  /// to each noise model and changes when a channel is added, copies share
+  /// it with their source.
+  std::size_t version = nextVersion();
+
 public:
   /// @brief default constructor
   noise_model() = default;
 
+  /// @brief Return the version of the contents of this noise model, which
+  /// simulators may use to cache data computed from its kraus_channels.
+  std::size_t get_version() const { return version; }
+
   /// @brief Return true if there are no kraus_channels in this noise model.
   /// @return
   bool empty() const { return noiseModel.empty(); }
@@ -89,14 +89,84 @@ public:
   /// @brief Return the coefficient of the identity term.
   /// @return
   double id_coefficient() {
-    for (std::size_t i = 0; i < spinOp.n_terms(); i++)
-      if (spinOp[i].is_identity())
-        return spinOp[i].get_term_coefficient(0).real();
-    return 0.0;
+    double coeff = 0.0;
+    spinOp.for_each_term_view([&](const spin_op::term_view &term) {
+      if (term.is_identity())
+        coeff = term.get_coefficient().real();
+    });
+    return coeff;
   }
 
   /// @brief Dump the counts data to standard out.
   void dump() { data.dump(); }
 };
 
+namespace details {
+
+/// @brief Return the one-term spin_op describing the product basis that
+/// measures all terms of the given group of qubit-wise commuting terms
+/// (see spin_op::group_qubit_wise_commuting).
+inline spin_op getMeasurementBasis(const spin_op &group) {
+  auto bsf = group.get_bsf();
+  std::vector<std::vector<bool>> basis{bsf[0]};
+  for (auto &row : bsf)
+    for (std::size_t i = 0; i < row.size(); i++)
+      if (row[i])
+        basis[0][i] = true;
+
+  std::vector<std::complex<double>> coeffs{1.0};
+  return spin_op::from_binary_symplectic(basis, coeffs);
+}
+
+/// @brief Return the measurement data of a single term of a qubit-wise
+/// commuting group, given the counts of the group's measurement basis
+/// circuit. The basis qubits are expected to be measured in ascending
+/// order, the term's counts are the marginal on its own support.
+inline ExecutionResult
+getGroupTermResult(const spin_op::term_view &term,
+                   const spin_op::term_view &basis, sample_result &counts,
+                   const std::string_view registerName = GlobalRegisterName) {
+  std::vector<std::size_t> positions;
+  for (std::size_t i = 0, position = 0; i < basis.n_qubits(); i++) {
+    if (basis.get_pauli(i) == pauli::I)
+      continue;
+    if (term.get_pauli(i) != pauli::I)
+      positions.push_back(position);
+    position++;
+  }
+
+  auto marginal = counts.get_marginal(positions, registerName);
+  return ExecutionResult(marginal.to_map(), term.to_string(),
+                         marginal.exp_val_z());
+}
+
+/// @brief Convert the counts of one measurement circuit per qubit-wise
+/// commuting group of H, stored in registers named after each group's
+/// measurement basis (or in the global register if there is a single
+/// circuit), to counts per term, stored in registers named after the terms.
+inline sample_result expandMeasurementGroups(spin_op &H,
+                                             sample_result &groupData) {
+  std::vector<std::pair<spin_op, spin_op>> measured;
+  for (auto &group : H.group_qubit_wise_commuting()) {
+    auto basis = getMeasurementBasis(group);
+    if (!basis.is_identity())
+      measured.emplace_back(group, basis);
+  }
+
+  std::vector<ExecutionResult> results;
+  for (auto &[group, basis] : measured) {
+    auto basisTerm = basis.get_term_view(0);
+    auto registerName =
+        measured.size() == 1 ? GlobalRegisterName : basisTerm.to_string();
+    group.for_each_term_view([&](const spin_op::term_view &term) {
+      if (!term.is_identity())
+        results.emplace_back(
+            getGroupTermResult(term, basisTerm, groupData, registerName));
+    });
+  }
+
+  return sample_result(results);
+}
+} // namespace details
+
 } // namespace cudaq
@@ -7,13 +7,27 @@
  *******************************************************************************/
 
 #pragma once
+#include "cudaq/platform/QuantumExecutionQueue.h"
 #include "observe.h"
 #include <cudaq/builder.h>
 #include <cudaq/spin_op.h>
 #include <functional>
+#include <future>
+#include <thread>
 
 namespace cudaq {
 
+namespace details {
+/// @brief Return the queue whose worker threads evaluate the expected
+/// values of gradient computations on single QPU simulator platforms. The
+/// workers are kept across computations, so that each keeps its simulator.
+inline QuantumExecutionQueue &getGradientQueue() {
+  static QuantumExecutionQueue queue(
+      std::max(1u, std::thread::hardware_concurrency()));
+  return queue;
+}
+} // namespace details
+
 ///
 /// \brief The cudaq::gradient represents a base type for all gradient
 /// strategies leveraged by variational algorithms.
@@ -43,6 +57,76 @@ protected:
     return cudaq::observe(ansatz_functor, h, x);
   }
 
+  // Given a list of parameter sets xs and the spin_op h, compute the
+  // expected value with respect to the ansatz at each of them. The
+  // evaluations are dispatched at once, across the QPUs of multi-QPU
+  // platforms, or across a pool of threads, each with its own simulator,
+  // on single QPU simulator platforms.
+  std::vector<double> getExpectedValues(std::vector<std::vector<double>> &xs,
+                                        spin_op &h) {
+    std::vector<double> values(xs.size());
+    auto &platform = cudaq::get_platform();
+    if (auto nQpus = platform.num_qpus(); nQpus > 1) {
+      std::vector<async_observe_result> results;
+      for (std::size_t i = 0; i < xs.size(); i++)
+        results.emplace_back(
+            observe_async(i % nQpus, ansatz_functor, h, xs[i]));
+      for (std::size_t i = 0; i < xs.size(); i++)
+        values[i] = results[i].get().exp_val_z();
+      return values;
+    }
+
+    if (xs.size() < 2 || !platform.is_simulator() || platform.is_remote()) {
+      for (std::size_t i = 0; i < xs.size(); i++)
+        values[i] = getExpectedValue(xs[i], h);
+      return values;
+    }
+
+    // The first evaluation runs here, so that kernels compiled on their
+    // first invocation (e.g. cudaq::make_kernel) are compiled once.
+    values[0] = getExpectedValue(xs[0], h);
+
+    // Each worker thread has its own platform, created by its first task.
+    // Mark the worker first, so that platform does not start a worker pool
+    // of its own, and give it the shots and the noise model of this one.
+    auto shots = platform.get_shots();
+    auto *noise = platform.get_noise();
+    std::vector<std::future<double>> results;
+    for (std::size_t i = 1; i < xs.size(); i++) {
+      auto promise = std::make_shared<std::promise<double>>();
+      results.emplace_back(promise->get_future());
+      QuantumTask task = [&, i, promise]() {
+        try {
+          details::setSynchronousWorkerThread();
+          auto &workerPlatform = cudaq::get_platform();
+          if (shots.has_value())
+            workerPlatform.set_shots(shots.value());
+          else
+            workerPlatform.clear_shots();
+          workerPlatform.set_noise(noise);
+          promise->set_value(getExpectedValue(xs[i], h));
+        } catch (...) {
+          promise->set_exception(std::current_exception());
+        }
+      };
+      details::getGradientQueue().enqueue(task);
+    }
+
+    // Wait for every task before rethrowing, they reference xs and h.
+    std::exception_ptr error;
+    for (std::size_t i = 1; i < xs.size(); i++) {
+      try {
+        values[i] = results[i - 1].get();
+      } catch (...) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+    return values;
+  }
+
 public:
   /// Constructor, takes the quantum kernel with prescribed signature
   gradient(std::function<void(std::vector<double>)> &&kernel)
@@ -0,0 +1,118 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include "cudaq/algorithms/gradient.h"
+
+namespace cudaq::gradients {
+
+/// @brief The adjoint gradient differentiates the ansatz with the adjoint
+/// method on state vector simulators. The simulator records the gates of the
+/// ansatz, simulates them once, and undoes them one by one to get the
+/// derivative of the expectation value with respect to every gate parameter
+/// at the cost of a few circuit simulations, instead of the 2 per parameter
+/// of parameter_shift. The derivatives of the gate parameters with respect
+/// to the ansatz parameters are obtained by recording, but not simulating,
+/// the ansatz at x_i +- step. They are exact only if every gate parameter is
+/// an affine function of the ansatz parameters, like `2. * x0 - x1`. For
+/// other gate parameters, like `x0 * x0` or `std::sin(x0)`, they are central
+/// differences, so the gradient is accurate to O(step^2), as it is with
+/// central_difference. Backends that cannot differentiate the ansatz (e.g.
+/// noisy or remote ones, or with shots) fall back to central differences of
+/// the expectation value.
+class adjoint : public gradient {
+public:
+  using gradient::gradient;
+
+  /// The shift of the ansatz parameters used to map them to the gate
+  /// parameters, see above.
+  double step = 1e-3;
+
+  void compute(const std::vector<double> &x, std::vector<double> &dx,
+               spin_op &h, double exp_h) override {
+    compute_value_and_gradient(x, dx, h);
+  }
+
+  /// @brief Compute the gradient of the expectation value of `h` at the
+  /// parameters `x` into `dx`, and return the expectation value.
+  double compute_value_and_gradient(const std::vector<double> &x,
+                                    std::vector<double> &dx, spin_op &h) {
+    auto &platform = cudaq::get_platform();
+    auto shots = platform.get_shots().value_or(-1);
+    if (shots < 1 && !platform.is_remote()) {
+      // Invocation 0 is at x, invocations 2i + 1 and 2i + 2 at x_i +- step.
+      auto ctx = std::make_unique<ExecutionContext>("observe-gradient");
+      ctx->kernelName = cudaq::getKernelName(ansatz_functor);
+      ctx->spin = &h;
+      ctx->batchSize = 2 * x.size() + 1;
+      platform.set_current_qpu(0);
+      platform.set_exec_ctx(ctx.get());
+      if (ctx->canHandleObserve) {
+        auto shiftedX = x;
+        ansatz_functor(shiftedX);
+        for (std::size_t i = 0; i < x.size(); i++) {
+          shiftedX[i] = x[i] + step;
+          ctx->batchIndex = 2 * i + 1;
+          ansatz_functor(shiftedX);
+          shiftedX[i] = x[i] - step;
+          ctx->batchIndex = 2 * i + 2;
+          ansatz_functor(shiftedX);
+          shiftedX[i] = x[i];
+        }
+      }
+      platform.reset_exec_ctx();
+
+      auto &parameters = ctx->batchGateParameters;
+      auto &gradients = ctx->gateParameterGradients;
+      if (ctx->expectationValue.has_value() &&
+          parameters.size() == ctx->batchSize) {
+        for (std::size_t i = 0; i < x.size(); i++) {
+          dx[i] = 0.;
+          for (std::size_t k = 0; k < gradients.size(); k++)
+            dx[i] += gradients[k] *
+                     (parameters[2 * i + 1][k] - parameters[2 * i + 2][k]) /
+                     (2. * step);
+        }
+        return ctx->expectationValue.value();
+      }
+    }
+
+    // Evaluate the shifted parameters of all x_i at once, x_i + step at
+    // position 2i and x_i - step at position 2i + 1, and x at the end.
+    std::vector<std::vector<double>> shiftedX(2 * x.size() + 1, x);
+    for (std::size_t i = 0; i < x.size(); i++) {
+      shiftedX[2 * i][i] += step;
+      shiftedX[2 * i + 1][i] -= step;
+    }
+    auto values = getExpectedValues(shiftedX, h);
+    for (std::size_t i = 0; i < x.size(); i++)
+      dx[i] = (values[2 * i] - values[2 * i + 1]) / (2. * step);
+    return values.back();
+  }
+
+  /// @brief Compute the gradient of the arbitrary function, `func`, passed
+  /// in by the user. There is no circuit to differentiate, this uses central
+  /// differences.
+  std::vector<double>
+  compute(const std::vector<double> &x,
+          std::function<double(std::vector<double>)> &func) override {
+    std::vector<double> dx(x.size());
+    auto tmpX = x;
+    for (std::size_t i = 0; i < x.size(); i++) {
+      tmpX[i] = x[i] + step;
+      double px = func(tmpX);
+      tmpX[i] = x[i] - step;
+      double mx = func(tmpX);
+      tmpX[i] = x[i];
+      dx[i] = (px - mx) / (2. * step);
+    }
+    return dx;
+  }
+};
+} // namespace cudaq::gradients
@@ -10,7 +10,14 @@
 
 #include <cudaq/spin_op.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <type_traits>
 #include <vector>
 
@@ -76,14 +83,13 @@ runObservation(KernelFunctor &&k, cudaq::spin_op &h, quantum_platform &platform,
   else {
     // If not, we have everything we need to compute it.
     double sum = 0.0;
-    for (std::size_t i = 0; i < h.n_terms(); i++) {
-      auto term = h[i];
+    h.for_each_term_view([&](const spin_op::term_view &term) {
+      auto coeff = term.get_coefficient().real();
       if (term.is_identity())
-        sum += term.get_coefficients()[0].real();
+        sum += coeff;
       else
-        sum += data.exp_val_z(term.to_string(false)) *
-               term.get_coefficients()[0].real();
-    }
+        sum += data.exp_val_z(term.to_string()) * coeff;
+    });
     expectationValue = sum;
   }
 
@@ -131,39 +137,154 @@ auto runObservationAsync(KernelFunctor &&wrappedKernel, spin_op &H,
       details::future(platform.enqueueAsyncTask(qpu_id, task)), &H);
 }
 
+/// @brief The number of chunks of terms per QPU distributeComputations
+/// splits a spin_op into when sampling it with shots. More chunks balance the
+/// load better, but each chunk runs the kernel again.
+constexpr std::size_t ObserveChunksPerQpu = 2;
+
+/// @brief Return the total estimated cost of the terms of the given spin_op
+/// (see spin_op::get_term_costs).
+inline std::size_t getObserveCost(const spin_op &op) {
+  auto costs = op.get_term_costs();
+  return std::accumulate(costs.begin(), costs.end(), std::size_t(0));
+}
+
+/// @brief Partition the terms of H into at most nChunks spin_ops of about
+/// equal estimated cost, ordered by decreasing cost. Groups of qubit-wise
+/// commuting terms are kept in one chunk, such that each group is still
+/// measured with a single circuit, unless there are fewer groups than chunks.
+inline std::vector<spin_op> partitionObservation(const spin_op &H,
+                                                 std::size_t nChunks) {
+  auto groups = H.group_qubit_wise_commuting();
+  std::vector<spin_op> chunks;
+  if (groups.size() < nChunks) {
+    chunks = H.distribute(nChunks);
+  } else {
+    // Assign the most expensive groups first to the least loaded chunk.
+    std::vector<std::pair<std::size_t, std::size_t>> groupCosts;
+    for (std::size_t g = 0; g < groups.size(); g++)
+      groupCosts.emplace_back(getObserveCost(groups[g]), g);
+    std::stable_sort(groupCosts.begin(), groupCosts.end(),
+                     [](auto &a, auto &b) { return a.first > b.first; });
+    std::vector<std::size_t> loads(nChunks, 0);
+    std::vector<std::optional<spin_op>> bins(nChunks);
+    for (auto &[cost, g] : groupCosts) {
+      auto c = std::distance(loads.begin(),
+                             std::min_element(loads.begin(), loads.end()));
+      loads[c] += cost;
+      if (bins[c])
+        *bins[c] += groups[g];
+      else
+        bins[c] = groups[g];
+    }
+    for (auto &bin : bins)
+      chunks.emplace_back(std::move(*bin));
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> chunkCosts;
+  for (std::size_t c = 0; c < chunks.size(); c++)
+    chunkCosts.emplace_back(getObserveCost(chunks[c]), c);
+  std::stable_sort(chunkCosts.begin(), chunkCosts.end(),
+                   [](auto &a, auto &b) { return a.first > b.first; });
+  std::vector<spin_op> sorted;
+  for (auto &[cost, c] : chunkCosts)
+    sorted.emplace_back(std::move(chunks[c]));
+  return sorted;
+}
+
 /// @brief Distribute the expectation value computations amongst the
 /// available platform QPUs. The asyncLauncher functor takes as input the
 /// qpu index and the spin_op chunk and returns an async_observe_result.
+/// The identity term is accounted for locally, the other terms are split
+/// into chunks of about equal estimated cost, and each QPU pulls the next
+/// (most expensive) chunk as soon as it completes its previous one. Without
+/// shots (shots < 1), the expectation value is computed exactly from a
+/// single state preparation per chunk, whatever its terms, so each QPU gets
+/// one chunk. The asyncLauncher is only called on the calling thread.
 inline auto distributeComputations(
     std::function<async_observe_result(std::size_t, spin_op &)> &&asyncLauncher,
-    spin_op &H, std::size_t nQpus) {
-
-  // Calculate how many terms we can equally divide amongst the qpus
-  auto nTermsPerQPU = H.n_terms() / nQpus + (H.n_terms() % nQpus != 0);
-
-  // Slice the given spin_op into subsets for each QPU
-  std::vector<spin_op> spins;
-  for (auto uniqueQpuId : cudaq::range(nQpus)) {
-    auto lowerBound = uniqueQpuId * nTermsPerQPU;
-    spins.emplace_back(H.slice(lowerBound, nTermsPerQPU));
-  }
-
-  // Observe each sub-spin_op asynchronously
-  std::vector<async_observe_result> asyncResults;
-  for (std::size_t i = 0; auto &op : spins) {
-    asyncResults.emplace_back(asyncLauncher(i, op));
-    i++;
+    spin_op &H, std::size_t nQpus, int shots) {
+
+  // Fold in the identity term locally, it does not need a QPU.
+  std::complex<double> identityCoeff = 0.0;
+  H.for_each_term_view([&](const spin_op::term_view &term) {
+    if (term.is_identity())
+      identityCoeff += term.get_coefficient();
+  });
+  spin_op terms = H - identityCoeff * spin_op();
+  if (terms.n_terms() == 0)
+    return observe_result(identityCoeff.real(), H, sample_result());
+
+  const std::size_t chunksPerQpu = shots < 1 ? 1 : ObserveChunksPerQpu;
+  auto chunks = partitionObservation(
+      terms, std::max<std::size_t>(1, nQpus) * chunksPerQpu);
+  nQpus = std::max<std::size_t>(1, std::min(nQpus, chunks.size()));
+
+  // Each launched chunk gets a thread waiting for its result, which then
+  // hands its QPU back to the scheduling loop below. The state the waiters
+  // use is declared before them, so it outlives them on every path.
+  std::vector<double> expectationValues(chunks.size(), 0.0);
+  std::vector<sample_result> chunkData(chunks.size());
+  std::mutex mutex;
+  std::condition_variable idleCondition;
+  std::vector<std::size_t> idleQpus;
+  std::exception_ptr error;
+  std::vector<std::future<void>> waiters;
+  auto launch = [&](std::size_t qpu, std::size_t c) {
+    auto asyncResult = asyncLauncher(qpu, chunks[c]);
+    waiters.emplace_back(std::async(
+        std::launch::async,
+        [&, qpu, c, asyncResult = std::move(asyncResult)]() mutable {
+          std::exception_ptr chunkError;
+          try {
+            auto res = asyncResult.get();
+            expectationValues[c] = res.exp_val_z();
+            chunkData[c] = res.raw_data();
+          } catch (...) {
+            chunkError = std::current_exception();
+          }
+          std::lock_guard<std::mutex> lock(mutex);
+          if (chunkError && !error)
+            error = chunkError;
+          idleQpus.push_back(qpu);
+          idleCondition.notify_one();
+        }));
+  };
+
+  // If a launch throws, the chunks already launched are waited for before
+  // the error is rethrown.
+  try {
+    std::size_t nextChunk = 0;
+    for (; nextChunk < nQpus; nextChunk++)
+      launch(nextChunk, nextChunk);
+    while (nextChunk < chunks.size()) {
+      std::size_t qpu;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        idleCondition.wait(lock, [&] { return !idleQpus.empty(); });
+        if (error)
+          break;
+        qpu = idleQpus.back();
+        idleQpus.pop_back();
+      }
+      launch(qpu, nextChunk++);
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error)
+      error = std::current_exception();
   }
+  for (auto &waiter : waiters)
+    waiter.wait();
+  if (error)
+    std::rethrow_exception(error);
 
-  // Wait for the results, should be executing
-  // in parallel on the available QPUs.
-  double result = 0.0;
+  // Combine the results in chunk order.
+  double result = identityCoeff.real();
   sample_result data;
-  for (auto &asyncResult : asyncResults) {
-    auto res = asyncResult.get();
-    result += res.exp_val_z();
-    auto incomingData = res.raw_data();
-    data += incomingData;
+  for (std::size_t c = 0; c < chunks.size(); c++) {
+    result += expectationValues[c];
+    data += chunkData[c];
   }
 
   return observe_result(result, H, data);
@@ -221,7 +342,7 @@ observe_result observe(QuantumKernel &&kernel, spin_op H, Args &&...args) {
           return observe_async(i, std::forward<QuantumKernel>(kernel), op,
                                std::forward<Args>(args)...);
         },
-        H, nQpus);
+        H, nQpus, shots);
 
   auto kernelName = cudaq::getKernelName(kernel);
   return details::runObservation(
@@ -279,12 +400,12 @@ observe_result observe(std::size_t shots, QuantumKernel &&kernel, spin_op H,
   // If so, let's distribute the work amongst the QPUs
   if (auto nQpus = platform.num_qpus(); nQpus > 1)
     return details::distributeComputations(
-        [&kernel, ... args = std::forward<Args>(args)](std::size_t i,
-                                                       spin_op &op) mutable {
-          return observe_async(i, std::forward<QuantumKernel>(kernel), op,
-                               std::forward<Args>(args)...);
+        [&kernel, shots, ... args = std::forward<Args>(args)](
+            std::size_t i, spin_op &op) mutable {
+          return observe_async(shots, i, std::forward<QuantumKernel>(kernel),
+                               op, std::forward<Args>(args)...);
         },
-        H, nQpus);
+        H, nQpus, static_cast<int>(shots));
 
   return details::runObservation(
              [&kernel, ... args = std::forward<Args>(args)]() mutable {
@@ -294,6 +415,69 @@ observe_result observe(std::size_t shots, QuantumKernel &&kernel, spin_op H,
       .value();
 }
 
+///
+/// \brief Compute the expected value of \p H with respect to kernel(x) for
+/// each parameter vector x of \p parameters.
+///
+/// \param kernel The instantiated ansatz callable, a CUDA Quantum kernel
+///         taking a std::vector<double>, cannot contain measure statements.
+/// \param H The hermitian cudaq::spin_op to compute the expected value for.
+/// \param parameters The parameter vectors to evaluate the kernel at.
+/// \returns The expected values <kernel(x)|H|kernel(x)>, in the order of
+///          \p parameters.
+///
+/// \details On backends that support it (the CPU state vector simulators,
+///          without shots), the kernel is invoked once per parameter vector
+///          to record its gates, and all circuits are simulated together,
+///          each gate being applied to all copies of the state with a single
+///          vectorized kernel. This amortizes the per-call overhead of
+///          observe for VQE iterations and gradients. On other backends, this
+///          is equivalent to calling observe for each parameter vector.
+///
+/// Usage:
+/// \code{.cpp}
+/// std::vector<std::vector<double>> parameters{{.1}, {.2}, {.3}};
+/// auto results = cudaq::observe_batch(ansatz{}, H, parameters);
+/// \endcode
+///
+template <typename QuantumKernel>
+  requires ObserveCallValid<QuantumKernel, std::vector<double>>
+std::vector<observe_result>
+observe_batch(QuantumKernel &&kernel, spin_op H,
+              const std::vector<std::vector<double>> &parameters) {
+  auto &platform = cudaq::get_platform();
+  auto shots = platform.get_shots().value_or(-1);
+  std::vector<observe_result> results;
+
+  if (shots < 1 && !parameters.empty() && !platform.is_remote()) {
+    auto ctx = std::make_unique<ExecutionContext>("observe-batch");
+    ctx->kernelName = cudaq::getKernelName(kernel);
+    ctx->spin = &H;
+    ctx->batchSize = parameters.size();
+    platform.set_current_qpu(0);
+    platform.set_exec_ctx(ctx.get());
+
+    // The backend records the circuit of each invocation, and simulates them
+    // all when the context is reset.
+    if (ctx->canHandleObserve)
+      for (std::size_t i = 0; auto &x : parameters) {
+        ctx->batchIndex = i++;
+        kernel(x);
+      }
+    platform.reset_exec_ctx();
+
+    if (ctx->batchExpectationValues.size() == parameters.size()) {
+      for (auto &expectationValue : ctx->batchExpectationValues)
+        results.emplace_back(expectationValue, H);
+      return results;
+    }
+  }
+
+  for (auto &x : parameters)
+    results.emplace_back(observe(kernel, H, x));
+  return results;
+}
+
 ///
 /// \brief Asynchronously compute the expected value of \p H with respect to
 /// kernel(Args...).
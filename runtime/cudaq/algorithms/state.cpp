@@ -8,16 +8,105 @@
 
 #include "state.h"
 #include <Eigen/Dense>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+/// @brief The header of a saved state file, followed by the raw data.
+struct StateFileHeader {
+  char magic[8] = {'C', 'U', 'D', 'A', 'Q', 'S', 'T', '\0'};
+  std::uint32_t version = 1;
+  std::uint32_t rank = 0;
+  std::uint64_t shape[2] = {0, 0};
+};
+static_assert(sizeof(StateFileHeader) % alignof(std::complex<double>) == 0,
+              "The state data must be aligned in the file.");
+} // namespace
 
 namespace cudaq {
 
+state::state(State d) : shape(std::move(std::get<0>(d))) {
+  auto owner = std::make_shared<std::vector<std::complex<double>>>(
+      std::move(std::get<1>(d)));
+  data = std::shared_ptr<std::complex<double>>(owner, owner->data());
+}
+
+state::state(StateHandle handle)
+    : shape(std::move(handle.first)), data(std::move(handle.second)) {}
+
+std::size_t state::size() const {
+  std::size_t size = 1;
+  for (auto extent : shape)
+    size *= extent;
+  return shape.empty() ? 0 : size;
+}
+
+void state::save(const std::string &fileName) const {
+  if (shape.empty() || shape.size() > 2)
+    throw std::runtime_error("Cannot save a state without data.");
+
+  StateFileHeader header;
+  header.rank = shape.size();
+  std::copy(shape.begin(), shape.end(), header.shape);
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(data.get()),
+             size() * sizeof(std::complex<double>));
+  if (!file)
+    throw std::runtime_error("Could not write the state to " + fileName + ".");
+}
+
+state state::load(const std::string &fileName) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Could not open the state file " + fileName + ".");
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0 ||
+      static_cast<std::size_t>(fileStat.st_size) < sizeof(StateFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Invalid state file " + fileName + ".");
+  }
+
+  // Map a private copy-on-write view, the data of the state may be modified
+  // without changing the file.
+  const std::size_t fileSize = fileStat.st_size;
+  void *mapped =
+      ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED)
+    throw std::runtime_error("Could not map the state file " + fileName + ".");
+  std::shared_ptr<char> owner(static_cast<char *>(mapped),
+                              [fileSize](char *p) { ::munmap(p, fileSize); });
+
+  StateFileHeader header, expected;
+  std::memcpy(&header, owner.get(), sizeof(header));
+  std::vector<std::size_t> shape(header.shape, header.shape + header.rank);
+  std::size_t size = header.rank ? 1 : 0;
+  for (auto extent : shape)
+    size *= extent;
+  if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+      header.version != expected.version || header.rank < 1 ||
+      header.rank > 2 ||
+      fileSize != sizeof(header) + size * sizeof(std::complex<double>))
+    throw std::runtime_error("Invalid state file " + fileName + ".");
+
+  auto *stateData =
+      reinterpret_cast<std::complex<double> *>(owner.get() + sizeof(header));
+  std::shared_ptr<std::complex<double>> handle(owner, stateData);
+  return state(StateHandle{std::move(shape), std::move(handle)});
+}
+
 void state::dump() { dump(std::cout); }
 void state::dump(std::ostream &os) {
-  auto &[shape, stateData] = data;
+  auto *stateData = data.get();
   if (shape.size() == 1) {
-    for (auto &d : stateData)
-      os << d.real() << " ";
+    for (std::size_t i = 0; i < shape[0]; i++)
+      os << stateData[i].real() << " ";
     os << "\n";
   } else {
     for (std::size_t i = 0; i < shape[0]; i++) {
@@ -29,41 +118,37 @@ void state::dump(std::ostream &os) {
   }
 }
 std::complex<double> state::operator[](std::size_t idx) {
-  auto &[shape, stateData] = data;
   if (shape.size() != 1)
     throw std::runtime_error("Cannot request 1-d index into density matrix. "
                              "Must be a state vector.");
-  return stateData[idx];
+  return data.get()[idx];
 }
 
 std::complex<double> state::operator()(std::size_t idx, std::size_t jdx) {
-  auto &[shape, stateData] = data;
-
   if (shape.size() != 2)
     throw std::runtime_error("Cannot request 2-d index into state vector. "
                              "Must be a density matrix.");
 
-  return stateData[idx * std::get<0>(data)[0] + jdx];
+  return data.get()[idx * shape[0] + jdx];
 }
 
 double state::overlap(state &other) {
   double sum = 0.0;
-  auto &[shape, stateData] = data;
-  if (shape.size() != std::get<0>(other.data).size())
+  if (shape.size() != other.shape.size())
     throw std::runtime_error(
         "Cannot compare state vectors and density matrices.");
 
   if (shape.size() == 1) {
-    for (std::size_t i = 0; i < std::get<1>(data).size(); i++) {
-      sum += std::abs(std::get<1>(data)[i] * other[i]);
+    for (std::size_t i = 0; i < size(); i++) {
+      sum += std::abs(data.get()[i] * other[i]);
     }
   } else {
 
     // Create rho and sigma matrices
     Eigen::MatrixXcd rho =
-        Eigen::Map<Eigen::MatrixXcd>(stateData.data(), shape[0], shape[1]);
-    Eigen::MatrixXcd sigma = Eigen::Map<Eigen::MatrixXcd>(
-        std::get<1>(other.data).data(), shape[0], shape[1]);
+        Eigen::Map<Eigen::MatrixXcd>(data.get(), shape[0], shape[1]);
+    Eigen::MatrixXcd sigma =
+        Eigen::Map<Eigen::MatrixXcd>(other.data.get(), shape[0], shape[1]);
 
     // For qubit systems, F(rho,sigma) = tr(rho*sigma) + 2 *
     // sqrt(det(rho)*det(sigma))
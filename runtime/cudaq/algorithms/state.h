@@ -11,21 +11,43 @@
 #include "common/ExecutionContext.h"
 #include "cudaq/platform.h"
 #include <complex>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace cudaq {
 
 /// @brief The cudaq::state encapsulate backend simulation state
-/// vector or density matrix data.
+/// vector or density matrix data. Copies of a state share the data.
 class state {
 
 private:
-  /// @brief Reference to the simulation data
-  State data;
+  /// @brief The shape of the data, (n) or (n,n)
+  std::vector<std::size_t> shape;
+
+  /// @brief Reference to the simulation data, which shares the ownership of
+  /// the memory it points into (e.g. simulator or memory mapped file memory)
+  std::shared_ptr<std::complex<double>> data;
+
+  /// @brief Return the number of elements of the data
+  std::size_t size() const;
 
 public:
   /// @brief The constructor, takes the simulation data
-  state(State d) : data(d) {}
+  state(State d);
+
+  /// @brief The constructor, takes a handle on the simulation data, which
+  /// is used without a copy.
+  state(StateHandle handle);
+
+  /// @brief Return the shape of the data, (n) for a state vector and (n,n)
+  /// for a density matrix.
+  const std::vector<std::size_t> &get_shape() const { return shape; }
+
+  /// @brief Return a pointer to the data. A density matrix is in row-major
+  /// order, element (i, j) at i * n + j, whatever the storage order of the
+  /// simulator. It remains valid as long as a copy of this state exists.
+  std::complex<double> *get_data() const { return data.get(); }
 
   /// @brief Return the data element at the given indices
   std::complex<double> operator[](std::size_t idx);
@@ -38,6 +60,15 @@ public:
   /// @brief Compute the overlap of this state
   /// with the other one.
   double overlap(state &other);
+
+  /// @brief Write the state to the given file, a fixed size header with the
+  /// shape followed by the raw data, see load().
+  void save(const std::string &fileName) const;
+
+  /// @brief Return the state saved in the given file. The file is memory
+  /// mapped, its data is read lazily by the operating system and is not
+  /// copied.
+  static state load(const std::string &fileName);
 };
 
 namespace details {
@@ -63,8 +94,25 @@ state extractState(KernelFunctor &&kernel) {
   kernel();
   platform.reset_exec_ctx();
 
-  // Return the state data.
-  return state(context.simulationData);
+  // Return the state data, without a copy if the simulator handed its
+  // memory over.
+  if (context.simulationDataHandle.second)
+    return state(std::move(context.simulationDataHandle));
+  return state(std::move(context.simulationData));
+}
+
+/// @brief Execute the given kernel functor in the given "extract-amplitudes"
+/// or "extract-probabilities" context, in which the simulator computes the
+/// requested quantities in place when the context is reset.
+template <typename KernelFunctor>
+void runStateQuery(ExecutionContext &context, KernelFunctor &&kernel) {
+  auto &platform = cudaq::get_platform();
+  if (!platform.is_simulator())
+    throw std::runtime_error("Cannot query the state on a physical QPU.");
+
+  platform.set_exec_ctx(&context);
+  kernel();
+  platform.reset_exec_ctx();
 }
 } // namespace details
 
@@ -78,4 +126,35 @@ auto get_state(QuantumKernel &&kernel, Args &&...args) {
       });
 }
 
+/// @brief Return the amplitudes of the given basis states in the state
+/// generated by the kernel at the given runtime arguments. Each basis state
+/// has one character, 0 or 1, per qubit, qubit 0 first. Only the requested
+/// amplitudes are read, the state is not copied.
+template <typename QuantumKernel, typename... Args>
+std::vector<std::complex<double>>
+get_amplitudes(QuantumKernel &&kernel,
+               const std::vector<std::string> &bitStrings, Args &&...args) {
+  ExecutionContext context("extract-amplitudes");
+  context.amplitudeBitStrings = bitStrings;
+  details::runStateQuery(
+      context, [&]() mutable { kernel(std::forward<Args>(args)...); });
+  return context.amplitudes;
+}
+
+/// @brief Return the probability of each outcome of measuring the given
+/// qubits (all qubits if empty) in the state generated by the kernel at the
+/// given runtime arguments, i.e. the marginal distribution of the qubits.
+/// The first qubit is the most significant bit of the outcome index. The
+/// probabilities are computed in place, the state is not copied.
+template <typename QuantumKernel, typename... Args>
+std::vector<double> get_probabilities(QuantumKernel &&kernel,
+                                      const std::vector<std::size_t> &qubits,
+                                      Args &&...args) {
+  ExecutionContext context("extract-probabilities");
+  context.probabilityQubits = qubits;
+  details::runStateQuery(
+      context, [&]() mutable { kernel(std::forward<Args>(args)...); });
+  return context.probabilities;
+}
+
 } // namespace cudaq
@@ -8,6 +8,7 @@
 
 #pragma once
 #include "gradient.h"
+#include "gradients/adjoint.h"
 #include "observe.h"
 #include "optimizer.h"
 
@@ -199,6 +200,53 @@ optimization_result vqe(QuantumKernel &&kernel, cudaq::gradient &gradient,
   });
 }
 
+///
+/// \brief Compute the minimal eigenvalue of \p H using VQE with the adjoint
+///        gradient.
+///
+/// \param kernel The ansatz, a quantum kernel callable, must have
+///        callable-type void(std::vector<double>) and no measures.
+/// \param gradient The cudaq::gradients::adjoint gradient of the ansatz.
+/// \param H The hermitian cudaq::spin_op to compute the minimal eigenvalue for.
+/// \param optimizer The cudaq::optimizer to use for iteratively searching for
+///        the minimal eigenvalue of \p H.
+/// \param n_params The number of variational parameters in the ansatz quantum
+///        kernel callable.
+/// \returns The optimal value and corresponding parameters as a
+///        cudaq::optimization_result (std::tuple<double,std::vector<double>>)
+///
+/// \details Same as the generic gradient overload, but when the optimizer
+/// requires gradients, the expectation value and all of its derivatives are
+/// computed together from a single recording of the ansatz.
+///
+/// Usage:
+/// \code{.cpp}
+/// cudaq::gradients::adjoint gradient(ansatz);
+/// cudaq::optimizers::lbfgs optimizer;
+/// auto [val, params] =
+///     cudaq::vqe(ansatz, gradient, H, optimizer, 1);
+/// \endcode
+///
+template <typename QuantumKernel>
+optimization_result vqe(QuantumKernel &&kernel,
+                        cudaq::gradients::adjoint &gradient, cudaq::spin_op H,
+                        cudaq::optimizer &optimizer, const int n_params) {
+  static_assert(
+      std::is_invocable_v<QuantumKernel, std::vector<double>>,
+      "Invalid parameterized quantum kernel expression. Must have "
+      "void(std::vector<double>) signature, or provide "
+      "std::tuple<Args...>(std::vector<double>) ArgMapper function object.");
+  auto requires_grad = optimizer.requiresGradients();
+  return optimizer.optimize(n_params, [&](const std::vector<double> &x,
+                                          std::vector<double> &grad_vec) {
+    double e = requires_grad
+                   ? gradient.compute_value_and_gradient(x, grad_vec, H)
+                   : cudaq::observe(kernel, H, x);
+    printf("<H> = %lf\n", e);
+    return e;
+  });
+}
+
 ///
 /// \brief Compute the minimal eigenvalue of \p H with VQE with a kernel
 ///        callable with non-trivial (not std::vector<double>) arg structure.
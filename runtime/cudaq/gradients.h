@@ -8,5 +8,6 @@
 
 #pragma once
 
+#include "algorithms/gradients/adjoint.h"
 #include "algorithms/gradients/central_difference.h"
 #include "algorithms/gradients/parameter_shift.h"
\ No newline at end of file
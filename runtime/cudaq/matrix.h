@@ -9,6 +9,7 @@
 #pragma once
 
 #include <complex>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -69,9 +70,30 @@ public:
   /// @brief Return the element at the ith row and jth column.
   value_type &operator()(std::size_t i, std::size_t j) const;
 
-  /// @brief Return the minimal eigenvalue for this matrix.
+  /// @brief Return the minimal eigenvalue for this matrix. Hermitian
+  /// matrices of dimension 1024 or more use the Lanczos iteration below with
+  /// its default tolerance instead of a full eigendecomposition, so the
+  /// result is within about 1e-10 * max(1, |eigenvalue|) of the dense one.
+  /// If the iteration does not converge, the full eigendecomposition is
+  /// used.
   value_type minimal_eigenvalue() const;
 
+  /// @brief Return the minimal eigenvalue of the Hermitian operator of the
+  /// given dimension defined by its matrix-vector product, computed with the
+  /// Lanczos iteration. The operator matrix is never formed, e.g. pass
+  /// spin_op::apply for a Hamiltonian too large for to_matrix(). Iterates
+  /// until the residual norm of the eigenvalue estimate is below
+  /// tolerance * max(1, |estimate|), which bounds the distance of the
+  /// estimate to an eigenvalue of the operator. Throws if that does not
+  /// happen within maxIterations products. The Lanczos vectors are not
+  /// reorthogonalized, which may slow down convergence but not the
+  /// residual test.
+  static value_type minimal_eigenvalue(
+      std::size_t dim,
+      const std::function<std::vector<value_type>(
+          const std::vector<value_type> &)> &product,
+      double tolerance = 1e-10, std::size_t maxIterations = 500);
+
   /// @brief Return this matrix's eigenvalues.
   std::vector<value_type> eigenvalues() const;
 
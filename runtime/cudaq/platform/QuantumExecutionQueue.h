@@ -9,12 +9,15 @@
 #pragma once
 
 #include "common/MeasureCounts.h"
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
-#include <queue>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace cudaq {
 
@@ -24,38 +27,65 @@ namespace cudaq {
 /// instance being provided and set.
 using QuantumTask = std::function<void()>;
 
-/// The QuantumExecutionQueue provides a queue running on a
-/// separate thread from the main CUDA Quantum host thread that clients
+/// The QuantumExecutionQueue provides a queue running on one or more
+/// threads separate from the main CUDA Quantum host thread that clients
 /// can submit execution tasks to, and these tasks will be executed
-/// (asynchronously from the calling thread) in the order they are submitted.
+/// (asynchronously from the calling thread). Each worker thread owns a
+/// deque of tasks, it executes tasks from the front of its own deque and
+/// steals from the back of the other workers' deques when its own is empty.
+/// With a single worker thread (the default), tasks are executed in the
+/// order they are submitted.
 class QuantumExecutionQueue {
 public:
-  /// The Constructor
-  QuantumExecutionQueue();
+  /// The Constructor, starts the given number of worker threads.
+  QuantumExecutionQueue(std::size_t numThreads = 1);
   /// The Destructor
   ~QuantumExecutionQueue();
 
   /// Enqueue a Sampling task.
   void enqueue(QuantumTask &task);
 
+  /// Return the number of worker threads.
+  std::size_t getNumThreads() const { return workers.size(); }
+
 protected:
-  /// The mutex, used for locking when adding to the queue
-  std::mutex lock;
+  /// A worker thread and the deque of tasks it owns.
+  struct Worker {
+    /// The mutex, used for locking when adding to or removing from the deque
+    std::mutex lock;
+
+    /// The tasks owned by this worker
+    std::deque<QuantumTask> tasks;
+
+    /// The thread this worker executes on
+    std::thread thread;
+  };
 
-  /// The thread this queue executes on
-  std::thread thread;
+  /// The workers, one per thread
+  std::vector<std::unique_ptr<Worker>> workers;
 
-  /// The execution queue
-  std::queue<QuantumTask> queue;
+  /// The mutex, used for waiting on new tasks or a quit signal
+  std::mutex lock;
 
   /// The condition variable used for notifying listeners
   std::condition_variable cv;
 
-  /// Should we quit this thread?
+  /// The number of tasks enqueued but not yet started
+  std::atomic<std::size_t> pending = 0;
+
+  /// The worker that receives the next task enqueued by a non-worker thread
+  std::atomic<std::size_t> nextWorker = 0;
+
+  /// Should we quit the worker threads?
   bool quit = false;
 
-  /// Main execution thread, loops until destruction,
-  /// continuously pops tasks off the queue and executes them
-  void handler(void);
+  /// Pop a task from the front of the given worker's deque, or steal one
+  /// from the back of another worker's deque. Return false if there are
+  /// no tasks left.
+  bool tryPop(std::size_t workerId, QuantumTask &task);
+
+  /// Main execution thread of the given worker, loops until destruction,
+  /// continuously pops tasks off the deques and executes them
+  void handler(std::size_t workerId);
 };
 } // namespace cudaq
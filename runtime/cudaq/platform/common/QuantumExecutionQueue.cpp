@@ -7,11 +7,26 @@
  *******************************************************************************/
 
 #include "cudaq/platform/QuantumExecutionQueue.h"
+#include <stdexcept>
 
 namespace cudaq {
 
-QuantumExecutionQueue::QuantumExecutionQueue() : lock() {
-  thread = std::thread(&QuantumExecutionQueue::handler, this);
+/// The queue and worker index of the worker running on this thread, tasks
+/// enqueued from within a task go to the back of the worker's own deque.
+thread_local static std::pair<QuantumExecutionQueue *, std::size_t>
+    currentWorker{nullptr, 0};
+
+QuantumExecutionQueue::QuantumExecutionQueue(std::size_t numThreads) {
+  if (numThreads == 0)
+    throw std::invalid_argument(
+        "QuantumExecutionQueue requires at least one thread.");
+
+  for (std::size_t i = 0; i < numThreads; i++)
+    workers.emplace_back(std::make_unique<Worker>());
+
+  // Start the threads once all workers exist, they steal from each other.
+  for (std::size_t i = 0; i < numThreads; i++)
+    workers[i]->thread = std::thread(&QuantumExecutionQueue::handler, this, i);
 }
 
 QuantumExecutionQueue::~QuantumExecutionQueue() {
@@ -19,38 +34,68 @@ QuantumExecutionQueue::~QuantumExecutionQueue() {
   quit = true;
   cv.notify_all();
   l.unlock();
-  if (thread.joinable()) {
-    thread.join();
-  }
+  for (auto &worker : workers)
+    if (worker->thread.joinable())
+      worker->thread.join();
 }
 
 void QuantumExecutionQueue::enqueue(QuantumTask &t) {
-  std::unique_lock<std::mutex> l(lock);
-  queue.push(t);
+  auto workerId = currentWorker.first == this
+                      ? currentWorker.second
+                      : nextWorker++ % workers.size();
+  {
+    auto &worker = *workers[workerId];
+    std::lock_guard<std::mutex> l(worker.lock);
+    worker.tasks.push_back(t);
+    pending++;
+  }
+
+  // Take the lock so that a worker about to wait cannot miss the
+  // notification.
+  { std::lock_guard<std::mutex> l(lock); }
   cv.notify_one();
-  return;
 }
 
-void QuantumExecutionQueue::handler(void) {
-  std::unique_lock<std::mutex> l(lock);
-
-  do {
-    // Wait until we have data or a quit signal
-    cv.wait(l, [this] { return (queue.size() || quit); });
+bool QuantumExecutionQueue::tryPop(std::size_t workerId, QuantumTask &task) {
+  {
+    auto &worker = *workers[workerId];
+    std::lock_guard<std::mutex> l(worker.lock);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      pending--;
+      return true;
+    }
+  }
 
-    // after wait, we own the lock
-    if (!quit && queue.size()) {
+  for (std::size_t i = 1; i < workers.size(); i++) {
+    auto &victim = *workers[(workerId + i) % workers.size()];
+    std::lock_guard<std::mutex> l(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      pending--;
+      return true;
+    }
+  }
 
-      auto op = std::move(queue.front());
-      queue.pop();
+  return false;
+}
 
-      // unlock now that we're done messing with the queue
-      l.unlock();
+void QuantumExecutionQueue::handler(std::size_t workerId) {
+  currentWorker = {this, workerId};
 
+  while (true) {
+    QuantumTask op;
+    if (tryPop(workerId, op))
       op();
-      l.lock();
-    }
-  } while (!quit);
+
+    // Wait until we have data or a quit signal
+    std::unique_lock<std::mutex> l(lock);
+    cv.wait(l, [this] { return pending > 0 || quit; });
+    if (quit)
+      return;
+  }
 }
 
 } // namespace cudaq
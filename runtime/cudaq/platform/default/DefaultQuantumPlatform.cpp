@@ -9,11 +9,16 @@
 #include "common/ExecutionContext.h"
 #include "common/Logger.h"
 #include "common/NoiseModel.h"
+#include "common/ObserveResult.h"
 #include "cudaq/platform/qpu.h"
 #include "cudaq/platform/quantum_platform.h"
 #include "cudaq/qis/qubit_qis.h"
 #include "cudaq/spin_op.h"
+#include <cstdlib>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
 
 /// This file defines the default, library mode, quantum platform.
 /// Its goal is to create a single QPU that is added to the quantum_platform
@@ -21,15 +26,69 @@
 
 LLVM_INSTANTIATE_REGISTRY(cudaq::QPU::RegistryType)
 
+namespace cudaq {
+void setQuantumPlatformInternal(quantum_platform *p);
+}
+
 namespace {
 /// The DefaultQPU models a simulated QPU by specifically
-/// targeting the QIS ExecutionManager.
+/// targeting the QIS ExecutionManager. Asynchronous tasks execute on a
+/// pool of CUDAQ_QPU_NUM_THREADS worker threads (1 by default), each with
+/// its own thread-local ExecutionManager and simulator, so the execution
+/// context is tracked per thread.
 class DefaultQPU : public cudaq::QPU {
+protected:
+  /// The platform this QPU belongs to
+  cudaq::quantum_platform *platform = nullptr;
+
+  /// The execution context of each thread running on this QPU
+  std::map<std::thread::id, cudaq::ExecutionContext *> contexts;
+
+  /// The mutex guarding the contexts map
+  std::mutex contextsLock;
+
+  /// @brief Make kernels launched from the calling worker thread target the
+  /// owning platform. Only done for the first task the worker executes.
+  void initializeWorkerThread() {
+    thread_local bool initialized = false;
+    if (initialized)
+      return;
+    initialized = true;
+
+    // Without this, the first kernel launched on this worker would create
+    // a new thread-local platform, with a worker pool of its own and
+    // without the target and noise model of the owning platform.
+    cudaq::setQuantumPlatformInternal(platform);
+  }
+
 public:
-  DefaultQPU() = default;
+  DefaultQPU(cudaq::quantum_platform *owner) : platform(owner) {
+    // Platforms of threads that evaluate kernels synchronously never
+    // enqueue tasks, keep the default single worker.
+    auto envVal = std::getenv("CUDAQ_QPU_NUM_THREADS");
+    if (!envVal || cudaq::details::isSynchronousWorkerThread())
+      return;
+
+    std::size_t numThreads = 0;
+    try {
+      numThreads = std::stoul(envVal);
+    } catch (...) {
+    }
+    if (numThreads == 0)
+      throw std::runtime_error("Invalid CUDAQ_QPU_NUM_THREADS environment "
+                               "variable, must be a positive integer.");
+
+    if (numThreads != execution_queue->getNumThreads())
+      execution_queue =
+          std::make_unique<cudaq::QuantumExecutionQueue>(numThreads);
+  }
 
   void enqueue(cudaq::QuantumTask &task) override {
-    execution_queue->enqueue(task);
+    cudaq::QuantumTask wrapped = [this, t = std::move(task)]() {
+      initializeWorkerThread();
+      t();
+    };
+    execution_queue->enqueue(wrapped);
   }
 
   void launchKernel(const std::string &name, void (*kernelFunc)(void *),
@@ -42,57 +101,34 @@ public:
   void setExecutionContext(cudaq::ExecutionContext *context) override {
     cudaq::ScopedTrace trace("DefaultPlatform::setExecutionContext",
                              context->name);
-    executionContext = context;
     if (noiseModel)
-      executionContext->noiseModel = noiseModel;
+      context->noiseModel = noiseModel;
 
-    cudaq::getExecutionManager()->setExecutionContext(executionContext);
+    {
+      std::lock_guard<std::mutex> l(contextsLock);
+      contexts[std::this_thread::get_id()] = context;
+    }
+    cudaq::getExecutionManager()->setExecutionContext(context);
   }
 
   /// Overrides resetExecutionContext to forward to
   /// the ExecutionManager. Also handles observe post-processing
   void resetExecutionContext() override {
-    cudaq::ScopedTrace trace("DefaultPlatform::resetExecutionContext",
-                             executionContext->name);
-
-    auto ctx = executionContext;
-    if (ctx && ctx->name == "observe") {
-      double sum = 0.0;
-      if (!ctx->spin.has_value())
-        throw std::runtime_error(
-            "Observe ExecutionContext specified without a cudaq::spin_op.");
-
-      std::vector<cudaq::ExecutionResult> results;
-      cudaq::spin_op &H = *ctx->spin.value();
-
-      // If the backend supports the observe task,
-      // let it compute the expectation value instead of
-      // manually looping over terms, applying basis change ops,
-      // and computing <ZZ..ZZZ>
-      if (executionContext->canHandleObserve) {
-        auto [exp, data] = cudaq::measure(H);
-        results.emplace_back(data.to_map(), H.to_string());
-        ctx->expectationValue = exp;
-        ctx->result = cudaq::sample_result(results);
-      } else {
-
-        // Loop over each term and compute coeff * <term>
-        H.for_each_term([&](cudaq::spin_op &term) {
-          if (term.is_identity())
-            sum += term.get_term_coefficient(0).real();
-          else {
-            auto [exp, data] = cudaq::measure(term);
-            results.emplace_back(data.to_map(), term.to_string(false), exp);
-            sum += term.get_term_coefficient(0).real() * exp;
-          }
-        });
-
-        ctx->expectationValue = sum;
-        ctx->result = cudaq::sample_result(sum, results);
+    cudaq::ExecutionContext *ctx = nullptr;
+    {
+      std::lock_guard<std::mutex> l(contextsLock);
+      auto iter = contexts.find(std::this_thread::get_id());
+      if (iter != contexts.end()) {
+        ctx = iter->second;
+        contexts.erase(iter);
       }
     }
+    cudaq::ScopedTrace trace("DefaultPlatform::resetExecutionContext",
+                             ctx ? ctx->name : "");
+
+    if (ctx && ctx->name == "observe")
+      handleObservation(ctx);
     cudaq::getExecutionManager()->resetExecutionContext();
-    executionContext = nullptr;
   }
 };
 
@@ -105,7 +141,7 @@ class DefaultQuantumPlatform : public cudaq::quantum_platform {
 public:
   DefaultQuantumPlatform() {
     // Populate the information and add the QPUs
-    platformQPUs.emplace_back(std::make_unique<DefaultQPU>());
+    platformQPUs.emplace_back(std::make_unique<DefaultQPU>(this));
     platformNumQPUs = platformQPUs.size();
   }
 
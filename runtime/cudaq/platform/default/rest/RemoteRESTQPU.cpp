@@ -9,6 +9,7 @@
 #include "Executor.h"
 #include "common/ExecutionContext.h"
 #include "common/Logger.h"
+#include "common/ObserveResult.h"
 #include "common/RestClient.h"
 #include "cudaq/platform/qpu.h"
 #include "nvqpp_config.h"
@@ -19,10 +20,12 @@
 #include <fmt/core.h>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <netinet/in.h>
 #include <regex>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unordered_map>
 
 #include "cudaq/Frontend/nvqpp/AttributeNames.h"
 #include "cudaq/Optimizer/CodeGen/Passes.h"
@@ -100,6 +103,45 @@ protected:
   /// configuration.
   std::map<std::string, std::string> backendConfig;
 
+  /// @brief A kernel lowered by the config-specified pass pipeline, before
+  /// any runtime argument is synthesized into it.
+  struct LoweredKernel {
+    /// The Quake code the kernel was lowered from
+    std::string quakeCode;
+
+    /// The module holding the lowered kernel
+    OwningOpRef<ModuleOp> module;
+
+    /// True if the kernel takes no arguments, the emitted codes are then
+    /// the same for every launch and are cached as well.
+    bool isArgumentFree = false;
+
+    /// The emitted code of each variant of an argument-free kernel, keyed
+    /// on the kernel name for sampling or the measurement basis for observe.
+    std::map<std::string, std::string> codes;
+  };
+
+  /// @brief The MLIRContext owning the lowered kernels
+  std::unique_ptr<MLIRContext> mlirContext;
+
+  /// @brief The lowered kernels, keyed on the target, code emission, pass
+  /// pipeline and kernel name.
+  std::unordered_map<std::string, LoweredKernel> loweredKernels;
+
+  /// @brief The mutex guarding the MLIRContext and the lowered kernels
+  std::mutex loweredKernelsLock;
+
+  /// @brief The attributes created by the argument synthesis of a launch
+  /// (e.g. the argument values) are uniqued in the MLIRContext and never
+  /// freed. The context and the lowered kernels are rebuilt after this many
+  /// launches that synthesized arguments, which bounds the memory at the
+  /// cost of lowering the kernels again once per this many launches.
+  static constexpr std::size_t MaxSynthesizingLaunches = 1000;
+
+  /// @brief The number of launches that synthesized arguments in the
+  /// current MLIRContext.
+  std::size_t synthesizingLaunches = 0;
+
 public:
   /// @brief The constructor
   RemoteRESTQPU() : QPU() {
@@ -209,18 +251,48 @@ public:
     executor->setServerHelper(serverHelper.get());
   }
 
-  /// @brief Extract the Quake representation for the given kernel name and
-  /// lower it to the code format required for the specific backend. The
-  /// lowering process is controllable via the platforms/BACKEND.config file for
-  /// this targeted backend.
-  std::vector<cudaq::KernelExecution>
-  lowerQuakeCode(const std::string &kernelName, void *kernelArgs) {
+  /// @brief Apply the given pass pipeline to the given ModuleOp
+  void runPassPipeline(const std::string &kernelName,
+                       const std::string &pipeline, ModuleOp moduleOp) {
+    PassManager pm(moduleOp.getContext());
+    std::string errMsg;
+    llvm::raw_string_ostream os(errMsg);
+    cudaq::info("Pass pipeline for {} = {}", kernelName, pipeline);
+    if (failed(parsePassPipeline(pipeline, pm, os)))
+      throw std::runtime_error(
+          "Remote rest platform failed to add passes to pipeline (" + errMsg +
+          ").");
+    if (failed(pm.run(moduleOp)))
+      throw std::runtime_error("Remote rest platform Quake lowering failed.");
+  }
 
-    auto contextPtr = cudaq::initializeMLIR();
-    MLIRContext &context = *contextPtr.get();
+  /// @brief Return the kernel with the given name, lowered by the
+  /// config-specified pass pipeline. The kernel is parsed and lowered on the
+  /// first launch only, later launches (e.g. VQE iterations) reuse it until
+  /// the MLIRContext is rebuilt.
+  LoweredKernel &getLoweredKernel(const std::string &kernelName) {
+    if (synthesizingLaunches >= MaxSynthesizingLaunches) {
+      cudaq::info("Rebuilding the MLIRContext after {} launches.",
+                  synthesizingLaunches);
+      // The lowered modules belong to the context, destroy them first.
+      loweredKernels.clear();
+      mlirContext.reset();
+      synthesizingLaunches = 0;
+    }
+    if (!mlirContext)
+      mlirContext = cudaq::initializeMLIR();
 
-    // Get the quake representation of the kernel
+    // The Quake code of a kernel name may change, e.g. for builder kernels
+    // that are extended after a launch.
     auto quakeCode = cudaq::get_quake_by_name(kernelName);
+    auto key = fmt::format("{};{};{};{}", qpuName, codegenTranslation,
+                           passPipelineConfig, kernelName);
+    auto iter = loweredKernels.find(key);
+    if (iter != loweredKernels.end() && iter->second.quakeCode == quakeCode)
+      return iter->second;
+
+    cudaq::info("Lowering kernel {} for {}.", kernelName, qpuName);
+    MLIRContext &context = *mlirContext;
     auto m_module = parseSourceString<ModuleOp>(quakeCode, &context);
 
     // Extract the kernel name
@@ -234,83 +306,99 @@ public:
     // FIXME this should be added to the builder.
     if (!func->hasAttr(cudaq::entryPointAttrName))
       func->setAttr(cudaq::entryPointAttrName, builder.getUnitAttr());
-    auto moduleOp = builder.create<ModuleOp>();
-    moduleOp.push_back(func.clone());
-
-    // Lambda to apply a specific pipeline to the given ModuleOp
-    auto runPassPipeline = [&](const std::string &pipeline,
-                               ModuleOp moduleOpIn) {
-      PassManager pm(&context);
-      std::string errMsg;
-      llvm::raw_string_ostream os(errMsg);
-      cudaq::info("Pass pipeline for {} = {}", kernelName, pipeline);
-      if (failed(parsePassPipeline(pipeline, pm, os)))
-        throw std::runtime_error(
-            "Remote rest platform failed to add passes to pipeline (" + errMsg +
-            ").");
-      if (failed(pm.run(moduleOpIn)))
-        throw std::runtime_error("Remote rest platform Quake lowering failed.");
-    };
+
+    LoweredKernel lowered;
+    lowered.quakeCode = quakeCode;
+    lowered.isArgumentFree = func.getNumArguments() == 0;
+    lowered.module = builder.create<ModuleOp>();
+    lowered.module->push_back(func.clone());
 
     // Run the config-specified pass pipeline
-    runPassPipeline(passPipelineConfig, moduleOp);
+    runPassPipeline(kernelName, passPipelineConfig, *lowered.module);
 
-    if (kernelArgs) {
-      PassManager pm(&context);
-      pm.addPass(cudaq::opt::createQuakeSynthesizer(kernelName, kernelArgs));
-      if (failed(pm.run(moduleOp)))
-        throw std::runtime_error("Could not successfully apply quake-synth.");
-    }
+    return loweredKernels.insert_or_assign(key, std::move(lowered))
+        .first->second;
+  }
 
-    std::vector<std::pair<std::string, ModuleOp>> modules;
-    // Apply observations if necessary
-    if (executionContext && executionContext->name == "observe") {
+  /// @brief Extract the Quake representation for the given kernel name and
+  /// lower it to the code format required for the specific backend. The
+  /// lowering process is controllable via the platforms/BACKEND.config file for
+  /// this targeted backend. Only the synthesis of the runtime arguments, the
+  /// observe measurements and the code emission are done on every launch.
+  std::vector<cudaq::KernelExecution>
+  lowerQuakeCode(const std::string &kernelName, void *kernelArgs) {
+    std::lock_guard<std::mutex> lock(loweredKernelsLock);
+    auto &lowered = getLoweredKernel(kernelName);
 
+    // Collect the code variants to emit, the kernel itself for sampling, or
+    // one measurement circuit per group of qubit-wise commuting terms for
+    // observe, all terms of a group share its counts.
+    std::vector<std::pair<std::string, std::vector<bool>>> variants;
+    if (executionContext && executionContext->name == "observe") {
       cudaq::spin_op &spin = *executionContext->spin.value();
-      for (std::size_t i = 0; i < spin.n_terms(); i++) {
-        auto term = spin[i];
-        if (term.is_identity())
-          continue;
+      for (auto &group : spin.group_qubit_wise_commuting()) {
+        auto basis = cudaq::details::getMeasurementBasis(group);
+        if (!basis.is_identity())
+          variants.emplace_back(basis.to_string(false), basis.get_bsf()[0]);
+      }
+    } else
+      variants.emplace_back(kernelName, std::vector<bool>());
 
-        // Get the ansatz
-        auto ansatz = moduleOp.lookupSymbol<func::FuncOp>(
-            std::string("__nvqpp__mlirgen__") + kernelName);
+    // Get the code gen translation
+    auto translation = cudaq::getTranslation(codegenTranslation);
 
-        // Create a new Module to clone the ansatz into it
-        auto tmpModuleOp = builder.create<ModuleOp>();
-        tmpModuleOp.push_back(ansatz.clone());
+    OwningOpRef<ModuleOp> synthesized;
+    std::vector<cudaq::KernelExecution> codes;
+    for (auto &[name, binarySymplecticForm] : variants) {
+      // The code of a kernel without arguments is the same for every launch.
+      if (lowered.isArgumentFree) {
+        auto iter = lowered.codes.find(name);
+        if (iter != lowered.codes.end()) {
+          codes.emplace_back(name, iter->second);
+          continue;
+        }
+      }
 
-        // Extract the binary symplectic encoding
-        auto binarySymplecticForm = term.get_bsf()[0];
+      // Synthesize the runtime arguments, once for all variants
+      if (!synthesized) {
+        synthesized = lowered.module->clone();
+        if (kernelArgs && !lowered.isArgumentFree) {
+          synthesizingLaunches++;
+          PassManager pm(mlirContext.get());
+          pm.addPass(
+              cudaq::opt::createQuakeSynthesizer(kernelName, kernelArgs));
+          if (failed(pm.run(*synthesized)))
+            throw std::runtime_error(
+                "Could not successfully apply quake-synth.");
+        }
+      }
 
-        // Create the pass manager, add the quake observe ansatz pass
+      ModuleOp moduleOp = *synthesized;
+      OwningOpRef<ModuleOp> measured;
+      if (!binarySymplecticForm.empty()) {
+        // Clone the ansatz, add the quake observe ansatz pass
         // and run it followed by the canonicalizer
-        PassManager pm(&context);
+        measured = synthesized->clone();
+        PassManager pm(mlirContext.get());
         OpPassManager &optPM = pm.nest<func::FuncOp>();
         optPM.addPass(
             cudaq::opt::createQuakeObserveAnsatzPass(binarySymplecticForm));
-        if (failed(pm.run(tmpModuleOp)))
+        if (failed(pm.run(*measured)))
           throw std::runtime_error("Could not apply measurements to ansatz.");
-        runPassPipeline("canonicalize", tmpModuleOp);
-        modules.emplace_back(term.to_string(false), tmpModuleOp);
+        runPassPipeline(kernelName, "canonicalize", *measured);
+        moduleOp = *measured;
       }
 
-    } else
-      modules.emplace_back(kernelName, moduleOp);
-
-    // Get the code gen translation
-    auto translation = cudaq::getTranslation(codegenTranslation);
-
-    // Apply user-specified codegen
-    std::vector<cudaq::KernelExecution> codes;
-    for (auto &[name, moduleOpI] : modules) {
+      // Apply user-specified codegen
       std::string codeStr;
       {
         llvm::raw_string_ostream outStr(codeStr);
-        if (failed(translation(moduleOpI, outStr)))
+        if (failed(translation(moduleOp, outStr)))
           throw std::runtime_error("Could not successfully translate to " +
                                    codegenTranslation + ".");
       }
+      if (lowered.isArgumentFree)
+        lowered.codes.emplace(name, codeStr);
       codes.emplace_back(name, codeStr);
     }
     return codes;
@@ -342,8 +430,12 @@ public:
       return;
     }
 
-    // Otherwise make this synchronous
+    // Otherwise make this synchronous. For observe, convert the counts
+    // of each measurement group to counts per term.
     executionContext->result = future.get();
+    if (executionContext->name == "observe")
+      executionContext->result = cudaq::details::expandMeasurementGroups(
+          *executionContext->spin.value(), executionContext->result);
   }
 };
 } // namespace
@@ -0,0 +1,246 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include "common/ExecutionContext.h"
+#include "common/Logger.h"
+#include "common/NoiseModel.h"
+#include "cudaq/platform/qpu.h"
+#include "cudaq/platform/quantum_platform.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
+/// This file defines the CPU multi-QPU platform. It exposes a set of
+/// virtual QPUs, each backed by the simulator of its own worker thread,
+/// and partitions the CPU cores available to the process among them, so
+/// that asynchronous tasks (and the term-wise distribution of observe)
+/// execute in parallel on nodes without GPUs.
+
+namespace cudaq {
+void setQuantumPlatformInternal(quantum_platform *p);
+}
+
+namespace {
+
+/// @brief Parse a Linux cpu list, e.g. 0-3,8,10-11, into core indices.
+std::vector<int> parseCpuList(const std::string &cpuList) {
+  std::vector<int> cores;
+  std::stringstream stream(cpuList);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n")
+      continue;
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first
+                                         : std::stoi(range.substr(dash + 1));
+    for (int core = first; core <= last; core++)
+      cores.push_back(core);
+  }
+  return cores;
+}
+
+/// @brief Return the CPU cores this process may run on, ordered by NUMA
+/// node, so that contiguous chunks of cores share a memory node.
+std::vector<int> getAvailableCores() {
+  std::vector<int> cores;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    for (int core = 0; core < CPU_SETSIZE; core++)
+      if (CPU_ISSET(core, &set))
+        cores.push_back(core);
+
+  if (cores.empty()) {
+    cores.resize(std::max(1u, std::thread::hardware_concurrency()));
+    std::iota(cores.begin(), cores.end(), 0);
+  }
+
+  // Map each core to its NUMA node, cores of unknown nodes go first.
+  std::map<int, int> coreNodes;
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    auto name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos)
+      continue;
+
+    std::ifstream cpuListFile(entry.path() / "cpulist");
+    std::string cpuList;
+    std::getline(cpuListFile, cpuList);
+    try {
+      for (auto core : parseCpuList(cpuList))
+        coreNodes[core] = std::stoi(name.substr(4));
+    } catch (...) {
+      cudaq::info("Could not parse the cpu list of NUMA {}.", name);
+    }
+  }
+
+  std::stable_sort(cores.begin(), cores.end(), [&](int a, int b) {
+    auto nodeA = coreNodes.count(a) ? coreNodes[a] : -1;
+    auto nodeB = coreNodes.count(b) ? coreNodes[b] : -1;
+    return nodeA < nodeB;
+  });
+  return cores;
+}
+
+/// @brief The CpuEmulatedQPU models a simulated QPU that executes its
+/// asynchronous tasks on a worker thread pinned to a subset of the CPU
+/// cores. The worker thread owns its own simulator instance, and OpenMP
+/// parallel regions of that simulator use the cores of this QPU.
+class CpuEmulatedQPU : public cudaq::QPU {
+protected:
+  /// The platform this QPU belongs to
+  cudaq::quantum_platform *platform = nullptr;
+
+  /// The CPU cores assigned to this QPU
+  std::vector<int> cores;
+
+  /// The execution context of each thread running on this QPU
+  std::map<std::thread::id, cudaq::ExecutionContext *> contexts;
+
+  /// The mutex guarding the contexts map
+  std::mutex contextsLock;
+
+  /// @brief Pin the calling worker thread to the cores of this QPU, and
+  /// make kernels launched from it target the owning platform. Only done
+  /// for the first task the worker executes.
+  void initializeWorkerThread() {
+    thread_local bool initialized = false;
+    if (initialized)
+      return;
+    initialized = true;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto core : cores)
+      CPU_SET(core, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+      cudaq::info("Could not pin the worker thread of QPU {}.", qpu_id);
+
+#ifdef HAS_OPENMP
+    omp_set_num_threads(cores.size());
+#endif
+
+    // Without this, the first kernel launched on this worker would create
+    // a new thread-local platform, with a worker per QPU of its own.
+    cudaq::setQuantumPlatformInternal(platform);
+  }
+
+public:
+  CpuEmulatedQPU(std::size_t id, cudaq::quantum_platform *owner,
+                 std::vector<int> qpuCores)
+      : QPU(id), platform(owner), cores(std::move(qpuCores)) {}
+
+  void enqueue(cudaq::QuantumTask &task) override {
+    cudaq::info("Enqueue Task on QPU {}", qpu_id);
+    cudaq::QuantumTask wrapped = [this, t = std::move(task)]() {
+      initializeWorkerThread();
+      t();
+    };
+    execution_queue->enqueue(wrapped);
+  }
+
+  void launchKernel(const std::string &name, void (*kernelFunc)(void *),
+                    void *args, std::uint64_t, std::uint64_t) override {
+    cudaq::ScopedTrace trace("CpuEmulatedQPU::launchKernel", qpu_id);
+    kernelFunc(args);
+  }
+
+  /// Overrides setExecutionContext to forward it to the ExecutionManager
+  void setExecutionContext(cudaq::ExecutionContext *context) override {
+    cudaq::info("MultiQPUCpuPlatform::setExecutionContext QPU {}", qpu_id);
+    if (noiseModel)
+      context->noiseModel = noiseModel;
+
+    {
+      std::lock_guard<std::mutex> l(contextsLock);
+      contexts[std::this_thread::get_id()] = context;
+    }
+    cudaq::getExecutionManager()->setExecutionContext(context);
+  }
+
+  /// Overrides resetExecutionContext to forward to
+  /// the ExecutionManager. Also handles observe post-processing
+  void resetExecutionContext() override {
+    cudaq::info("MultiQPUCpuPlatform::resetExecutionContext QPU {}", qpu_id);
+    cudaq::ExecutionContext *ctx = nullptr;
+    {
+      std::lock_guard<std::mutex> l(contextsLock);
+      auto iter = contexts.find(std::this_thread::get_id());
+      if (iter != contexts.end()) {
+        ctx = iter->second;
+        contexts.erase(iter);
+      }
+    }
+
+    if (ctx && ctx->name == "observe")
+      handleObservation(ctx);
+    cudaq::getExecutionManager()->resetExecutionContext();
+  }
+};
+
+/// @brief The MultiQPUCpuQuantumPlatform exposes CUDAQ_MQPU_NQPUS simulated
+/// QPUs (one per available core by default), and assigns each a contiguous
+/// chunk of the available cores, ordered by NUMA node.
+class MultiQPUCpuQuantumPlatform : public cudaq::quantum_platform {
+public:
+  ~MultiQPUCpuQuantumPlatform() = default;
+  MultiQPUCpuQuantumPlatform() {
+    auto cores = getAvailableCores();
+    std::size_t nQpus = cores.size();
+
+    if (auto envVal = std::getenv("CUDAQ_MQPU_NQPUS")) {
+      std::size_t specifiedNQpus = 0;
+      try {
+        specifiedNQpus = std::stoul(envVal);
+      } catch (...) {
+      }
+      if (specifiedNQpus == 0)
+        throw std::runtime_error("Invalid CUDAQ_MQPU_NQPUS environment "
+                                 "variable, must be a positive integer.");
+      nQpus = specifiedNQpus;
+    }
+
+    // Split the cores in nQpus contiguous chunks of (nearly) equal size. If
+    // there are more QPUs than cores, QPUs share cores round-robin.
+    for (std::size_t i = 0; i < nQpus; i++) {
+      std::vector<int> qpuCores;
+      if (nQpus <= cores.size()) {
+        auto begin = i * cores.size() / nQpus;
+        auto end = (i + 1) * cores.size() / nQpus;
+        qpuCores.assign(cores.begin() + begin, cores.begin() + end);
+      } else {
+        qpuCores.push_back(cores[i % cores.size()]);
+      }
+
+      cudaq::info("Emulated QPU (CPU) {} uses {} cores.", i, qpuCores.size());
+      platformQPUs.emplace_back(
+          std::make_unique<CpuEmulatedQPU>(i, this, std::move(qpuCores)));
+    }
+
+    platformNumQPUs = platformQPUs.size();
+    platformCurrentQPU = 0;
+  }
+};
+} // namespace
+
+CUDAQ_REGISTER_PLATFORM(MultiQPUCpuQuantumPlatform, mqpu_cpu)
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "QuantumExecutionQueue.h"
+#include "common/ExecutionContext.h"
+#include "common/ObserveResult.h"
 #include "common/Registry.h"
 #include "cudaq/qis/execution_manager.h"
 #include "cudaq/utils/cudaq_utils.h"
@@ -42,6 +44,70 @@ protected:
   ExecutionContext *executionContext = nullptr;
   noise_model *noiseModel = nullptr;
 
+  /// @brief Compute the expectation value and measurement results of the
+  /// spin_op in the given observe ExecutionContext, for a kernel that has
+  /// just executed on the current ExecutionManager. Meant to be called by
+  /// subtypes from resetExecutionContext.
+  void handleObservation(ExecutionContext *ctx) {
+    if (!ctx->spin.has_value())
+      throw std::runtime_error(
+          "Observe ExecutionContext specified without a cudaq::spin_op.");
+
+    double sum = 0.0;
+    std::vector<ExecutionResult> results;
+    spin_op &H = *ctx->spin.value();
+    auto *executionManager = getExecutionManager();
+
+    // If the backend supports the observe task,
+    // let it compute the expectation value instead of
+    // manually looping over terms, applying basis change ops,
+    // and computing <ZZ..ZZZ>
+    if (ctx->canHandleObserve) {
+      auto [exp, data] = executionManager->measure(H);
+      results.emplace_back(data.to_map(), H.to_string());
+      ctx->expectationValue = exp;
+      ctx->result = sample_result(exp, results);
+      return;
+    }
+
+    if (static_cast<int>(ctx->shots) > 0) {
+      // Measure each group of qubit-wise commuting terms with a single
+      // circuit, and extract the counts of each term from the shared
+      // counts of its group.
+      for (auto &group : H.group_qubit_wise_commuting()) {
+        auto basis = details::getMeasurementBasis(group);
+        auto data = basis.is_identity()
+                        ? sample_result()
+                        : executionManager->measure(basis).second;
+        auto basisTerm = basis.get_term_view(0);
+        group.for_each_term_view([&](const spin_op::term_view &term) {
+          auto coeff = term.get_coefficient().real();
+          if (term.is_identity()) {
+            sum += coeff;
+            return;
+          }
+          auto &result = results.emplace_back(
+              details::getGroupTermResult(term, basisTerm, data));
+          sum += coeff * result.expectationValue.value();
+        });
+      }
+    } else {
+      // Loop over each term and compute coeff * <term>
+      H.for_each_term([&](spin_op &term) {
+        if (term.is_identity())
+          sum += term.get_term_coefficient(0).real();
+        else {
+          auto [exp, data] = executionManager->measure(term);
+          results.emplace_back(data.to_map(), term.to_string(false), exp);
+          sum += term.get_term_coefficient(0).real() * exp;
+        }
+      });
+    }
+
+    ctx->expectationValue = sum;
+    ctx->result = sample_result(sum, results);
+  }
+
 public:
   /// The constructor, initializes the execution queue
   QPU() : execution_queue(std::make_unique<QuantumExecutionQueue>()) {}
@@ -56,6 +122,8 @@ public:
   virtual ~QPU() = default;
 
   virtual void setNoiseModel(noise_model *model) { noiseModel = model; }
+  /// Return the noise model of this QPU, null if there is none
+  noise_model *getNoiseModel() { return noiseModel; }
 
   /// Return the number of qubits
   std::size_t getNumQubits() { return numQubits; }
@@ -38,6 +38,12 @@ thread_local static quantum_platform *platform;
 inline static constexpr std::string_view GetQuantumPlatformSymbol =
     "getQuantumPlatform";
 
+thread_local static bool synchronousWorkerThread = false;
+
+void details::setSynchronousWorkerThread() { synchronousWorkerThread = true; }
+
+bool details::isSynchronousWorkerThread() { return synchronousWorkerThread; }
+
 void setQuantumPlatformInternal(quantum_platform *p) {
   cudaq::info("external caller setting the platform.");
   platform = p;
@@ -57,6 +63,10 @@ void quantum_platform::set_noise(noise_model *model) {
   platformQPU->setNoiseModel(model);
 }
 
+noise_model *quantum_platform::get_noise() {
+  return platformQPUs[platformCurrentQPU]->getNoiseModel();
+}
+
 std::future<sample_result>
 quantum_platform::enqueueAsyncTask(const std::size_t qpu_id,
                                    KernelExecutionTask &task) {
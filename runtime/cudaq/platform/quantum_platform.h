@@ -95,6 +95,9 @@ public:
 
   void set_noise(noise_model *model);
 
+  /// Return the noise model of the current QPU, null if there is none.
+  noise_model *get_noise();
+
   /// Enqueue an asynchronous sampling task.
   std::future<sample_result> enqueueAsyncTask(const std::size_t qpu_id,
                                               KernelExecutionTask &t);
@@ -143,6 +146,18 @@ protected:
   ExecutionContext *executionContext = nullptr;
 };
 
+namespace details {
+/// @brief Mark the calling thread as a worker that evaluates kernels
+/// synchronously, e.g. a gradient worker. Platforms created on it give
+/// their QPUs a single-threaded execution queue instead of the worker pool
+/// requested by CUDAQ_QPU_NUM_THREADS.
+void setSynchronousWorkerThread();
+
+/// @brief Return true if the calling thread was marked with
+/// setSynchronousWorkerThread().
+bool isSynchronousWorkerThread();
+} // namespace details
+
 /// Entry point for the auto-generated kernel execution path. TODO: Needs to be
 /// tied to the quantum platform instance somehow. Note that the compiler cannot
 /// provide that information.
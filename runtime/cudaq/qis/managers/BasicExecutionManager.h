@@ -139,6 +139,11 @@ public:
       return;
     }
 
+    // Each kernel invocation of a batched observe task is recorded
+    // separately, run its instructions before the next one reuses the qudits.
+    if (ctx_name == "observe-batch" || ctx_name == "observe-gradient")
+      synchronize();
+
     deallocateQudit(qid.id);
     returnIndex(qid.id);
     if (numAvailable() == totalNumQudits()) {
@@ -66,6 +66,12 @@ void __quantum__qis__rz__ctl(double, Array *ctls, Qubit *q);
 void __quantum__qis__r1(double, Qubit *q);
 void __quantum__qis__r1__ctl(double, Array *ctls, Qubit *q);
 
+void __quantum__qis__u2(double, double, Qubit *q);
+void __quantum__qis__u2__ctl(double, double, Array *ctls, Qubit *q);
+
+void __quantum__qis__u3(double, double, double, Qubit *q);
+void __quantum__qis__u3__ctl(double, double, double, Array *ctls, Qubit *q);
+
 void __quantum__qis__swap(Qubit *, Qubit *);
 void __quantum__qis__cphase(double x, Qubit *src, Qubit *tgt);
 
@@ -98,6 +98,17 @@ private:
              a != nullptr ? __quantum__qis__r1__ctl(d[0], a, q[0])
                           : __quantum__qis__r1(d[0], q[0]);
            }},
+          {"u2",
+           [](std::vector<double> d, Array *a, std::vector<Qubit *> &q) {
+             a != nullptr ? __quantum__qis__u2__ctl(d[0], d[1], a, q[0])
+                          : __quantum__qis__u2(d[0], d[1], q[0]);
+           }},
+          {"u3",
+           [](std::vector<double> d, Array *a, std::vector<Qubit *> &q) {
+             a != nullptr
+                 ? __quantum__qis__u3__ctl(d[0], d[1], d[2], a, q[0])
+                 : __quantum__qis__u3(d[0], d[1], d[2], q[0]);
+           }},
           {"swap",
            [](std::vector<double> d, Array *a, std::vector<Qubit *> &q) {
              __quantum__qis__swap(q[0], q[1]);
@@ -227,6 +227,38 @@ CUDAQ_QIS_PARAM_ONE_TARGET_(ry)
 CUDAQ_QIS_PARAM_ONE_TARGET_(rz)
 CUDAQ_QIS_PARAM_ONE_TARGET_(r1)
 
+// Define the general single qubit rotations u2(phi, lambda) and
+// u3(theta, phi, lambda). Their adjoints do not negate the angles, only the
+// base and ctrl versions exist.
+template <typename mod = base, typename... QubitArgs>
+void u2(double phi, double lambda, QubitArgs &...args) {
+  static_assert(!std::is_same_v<mod, adj>, "u2<cudaq::adj> is not supported");
+  std::vector<QuditInfo> targets{qubitToQuditInfo(args)...};
+  if constexpr (std::is_same_v<mod, base>) {
+    for (auto &targetId : targets)
+      getExecutionManager()->apply("u2", {phi, lambda}, {}, {targetId});
+    return;
+  }
+  std::vector<QuditInfo> controls(targets.begin(), targets.end() - 1);
+  getExecutionManager()->apply("u2", {phi, lambda}, controls,
+                               {targets.back()});
+}
+
+template <typename mod = base, typename... QubitArgs>
+void u3(double theta, double phi, double lambda, QubitArgs &...args) {
+  static_assert(!std::is_same_v<mod, adj>, "u3<cudaq::adj> is not supported");
+  std::vector<QuditInfo> targets{qubitToQuditInfo(args)...};
+  if constexpr (std::is_same_v<mod, base>) {
+    for (auto &targetId : targets)
+      getExecutionManager()->apply("u3", {theta, phi, lambda}, {},
+                                   {targetId});
+    return;
+  }
+  std::vector<QuditInfo> controls(targets.begin(), targets.end() - 1);
+  getExecutionManager()->apply("u3", {theta, phi, lambda}, controls,
+                               {targets.back()});
+}
+
 // Define the swap gate instruction and control versions of it
 namespace types {
 struct swap {
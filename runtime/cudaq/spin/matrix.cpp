@@ -13,6 +13,9 @@
 #include <Eigen/Dense>
 #include <fmt/core.h>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
 
 namespace cudaq {
 
@@ -154,8 +157,95 @@ complex_matrix complex_matrix::eigenvectors() const {
   return copy;
 }
 
+/// @brief Hermitian matrices of at least this dimension compute their
+/// minimal eigenvalue with the Lanczos iteration.
+static constexpr std::size_t LanczosMinDimension = 1024;
+
 complex_matrix::value_type complex_matrix::minimal_eigenvalue() const {
-  return eigenvalues()[0];
+  Eigen::Map<Eigen::MatrixXcd> map(internalData, nRows, nCols);
+  if (nRows < LanczosMinDimension || nRows != nCols ||
+      !map.isApprox(map.adjoint()))
+    return eigenvalues()[0];
+
+  // Fall back to the full eigendecomposition if Lanczos does not converge.
+  try {
+    return minimal_eigenvalue(nRows, [&](const std::vector<value_type> &v) {
+      std::vector<value_type> result(v.size());
+      Eigen::VectorXcd::Map(result.data(), result.size()) =
+          map * Eigen::VectorXcd::Map(v.data(), v.size());
+      return result;
+    });
+  } catch (std::runtime_error &) {
+    return eigenvalues()[0];
+  }
+}
+
+complex_matrix::value_type complex_matrix::minimal_eigenvalue(
+    std::size_t dim,
+    const std::function<std::vector<value_type>(
+        const std::vector<value_type> &)> &product,
+    double tolerance, std::size_t maxIterations) {
+  if (dim == 0)
+    throw std::runtime_error("Cannot compute the minimal eigenvalue of an "
+                             "operator of dimension 0.");
+
+  // Start from a fixed pseudo-random vector, such that the result is
+  // reproducible and the start vector overlaps with the ground state.
+  std::mt19937 gen(13);
+  std::normal_distribution<double> normal;
+  std::vector<value_type> v(dim), vPrev(dim, 0.0);
+  for (auto &e : v)
+    e = value_type(normal(gen), normal(gen));
+  Eigen::VectorXcd::Map(v.data(), dim).normalize();
+
+  // Build the tridiagonal projection T of the operator onto the Krylov
+  // space one Lanczos vector at a time. The lowest eigenvalue theta of T
+  // has the residual norm |beta_k * s_k|, with s the eigenvector of T.
+  std::vector<double> alphas, betas;
+  double theta = 0.0, betaPrev = 0.0, residual = 0.0;
+  bool converged = false;
+  for (std::size_t k = 0; k < std::min(dim, maxIterations); k++) {
+    auto w = product(v);
+    if (w.size() != dim)
+      throw std::runtime_error("Invalid operator product size in Lanczos "
+                               "iteration, expected " +
+                               std::to_string(dim) + " elements, got " +
+                               std::to_string(w.size()) + ".");
+    auto wMap = Eigen::VectorXcd::Map(w.data(), dim);
+    auto vMap = Eigen::VectorXcd::Map(v.data(), dim);
+    auto vPrevMap = Eigen::VectorXcd::Map(vPrev.data(), dim);
+    const double alpha = vMap.dot(wMap).real();
+    wMap -= alpha * vMap + betaPrev * vPrevMap;
+    const double beta = wMap.norm();
+    alphas.push_back(alpha);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver;
+    solver.computeFromTridiagonal(
+        Eigen::VectorXd::Map(alphas.data(), alphas.size()),
+        Eigen::VectorXd::Map(betas.data(), betas.size()),
+        Eigen::ComputeEigenvectors);
+    theta = solver.eigenvalues()[0];
+    residual = beta * std::abs(solver.eigenvectors()(k, 0));
+    converged = residual <= tolerance * std::max(1.0, std::abs(theta)) ||
+                beta <= std::numeric_limits<double>::epsilon() *
+                            std::max(1.0, std::abs(alpha));
+    if (converged)
+      break;
+
+    betas.push_back(beta);
+    vPrev.swap(v);
+    v.swap(w);
+    Eigen::VectorXcd::Map(v.data(), dim) /= beta;
+    betaPrev = beta;
+  }
+
+  if (!converged)
+    throw std::runtime_error(
+        "The Lanczos iteration did not converge after " +
+        std::to_string(alphas.size()) + " iterations, the residual norm " +
+        std::to_string(residual) + " of the eigenvalue estimate " +
+        std::to_string(theta) + " is above the tolerance.");
+  return theta;
 }
 
 } // namespace cudaq
\ No newline at end of file
@@ -14,72 +14,157 @@
 
 #include <Eigen/Dense>
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <complex>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <numeric>
+#include <optional>
+#include <queue>
 #include <random>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
 namespace cudaq {
 
-/// @brief Compute the action
-/// @param term
-/// @param bitConfiguration
-/// @return
-std::pair<std::string, std::complex<double>>
-actionOnBra(spin_op &term, const std::string &bitConfiguration) {
-  auto coeff = term.get_coefficients()[0];
-  auto newConfiguration = bitConfiguration;
-  std::complex<double> i(0, 1);
-
-  term.for_each_pauli([&](pauli p, std::size_t idx) {
-    if (p == pauli::Z) {
-      coeff *= (newConfiguration[idx] == '1' ? -1 : 1);
-    } else if (p == pauli::X) {
-      newConfiguration[idx] = newConfiguration[idx] == '1' ? '0' : '1';
-    } else if (p == pauli::Y) {
-      coeff *= (newConfiguration[idx] == '1' ? i : -i);
-      newConfiguration[idx] = (newConfiguration[idx] == '1' ? '0' : '1');
+std::vector<std::tuple<std::uint64_t, std::uint64_t, std::complex<double>>>
+spin_op::getIndexMasks() const {
+  if (m_n_qubits >= 64)
+    throw std::runtime_error(
+        "Cannot represent a spin_op on 64 or more qubits as a matrix.");
+
+  const std::complex<double> minusIPowers[] = {
+      1.0, std::complex<double>(0, -1), -1.0, std::complex<double>(0, 1)};
+  std::vector<std::tuple<std::uint64_t, std::uint64_t, std::complex<double>>>
+      masks;
+  masks.reserve(n_terms());
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    auto term = getTermData(t);
+    std::uint64_t xMask = 0, zMask = 0;
+    std::size_t nY = 0;
+    for (std::size_t q = 0; q < m_n_qubits; q++) {
+      const bool x = (term[q / 64] >> (q % 64)) & 1;
+      const bool z = (term[q / 64 + m_n_words] >> (q % 64)) & 1;
+      const auto bit = 1ULL << (m_n_qubits - 1 - q);
+      xMask |= x ? bit : 0;
+      zMask |= z ? bit : 0;
+      nY += x && z;
     }
-  });
-
-  return std::make_pair(newConfiguration, coeff);
+    masks.emplace_back(xMask, zMask, coefficients[t] * minusIPowers[nY % 4]);
+  }
+  return masks;
 }
 
 complex_matrix spin_op::to_matrix() const {
-  auto n = n_qubits();
-  auto dim = 1UL << n;
-  auto getBitStrForIdx = [&](std::size_t i) {
-    std::stringstream s;
-    for (int k = n - 1; k >= 0; k--)
-      s << ((i >> k) & 1);
-    return s.str();
-  };
-
-  // To construct the matrix, we are looping over every
-  // row, computing the binary representation for that index,
-  // e.g <100110|, and then we will compute the action of
-  // each pauli term on that binary configuration, returning a new
-  // product state and coefficient. Call this new state <colState|,
-  // we then compute <rowState | Paulis | colState> and set it in the matrix
-  // data.
-
+  // Each term maps row r to the single column r ^ xMask, see getIndexMasks().
+  const auto masks = getIndexMasks();
+  const std::size_t dim = 1ULL << m_n_qubits;
   complex_matrix A(dim, dim);
   A.set_zero();
   auto rawData = A.data();
-#pragma omp parallel for shared(rawData)
+#pragma omp parallel for
+  for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++)
+    for (auto &[xMask, zMask, coeff] : masks)
+      rawData[rowIdx * dim + (rowIdx ^ xMask)] +=
+          std::popcount(rowIdx & zMask) % 2 ? -coeff : coeff;
+  return A;
+}
+
+csr_spmatrix spin_op::to_sparse_matrix() const {
+  // Terms with the same X mask share the column of every row, merge them
+  // and order the merged terms by the column of each row.
+  auto masks = getIndexMasks();
+  std::sort(masks.begin(), masks.end(), [](auto &a, auto &b) {
+    return std::get<0>(a) < std::get<0>(b);
+  });
+  std::vector<std::uint64_t> xMasks;
+  std::vector<std::size_t> groupOffsets;
+  for (std::size_t t = 0; t < masks.size(); t++)
+    if (t == 0 || std::get<0>(masks[t]) != xMasks.back()) {
+      xMasks.push_back(std::get<0>(masks[t]));
+      groupOffsets.push_back(t);
+    }
+  groupOffsets.push_back(masks.size());
+
+  const std::size_t dim = 1ULL << m_n_qubits;
+  const std::size_t nGroups = xMasks.size();
+  std::vector<std::complex<double>> rowValues(dim * nGroups);
+  std::vector<std::size_t> rowColumns(dim * nGroups);
+  std::vector<std::size_t> rowOffsets(dim + 1, 0);
+#pragma omp parallel
+  {
+    std::vector<std::pair<std::size_t, std::complex<double>>> entries;
+#pragma omp for
+    for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
+      entries.clear();
+      for (std::size_t g = 0; g < nGroups; g++) {
+        std::complex<double> value = 0.0;
+        for (auto t = groupOffsets[g]; t < groupOffsets[g + 1]; t++) {
+          auto &[xMask, zMask, coeff] = masks[t];
+          value += std::popcount(rowIdx & zMask) % 2 ? -coeff : coeff;
+        }
+        if (value != 0.0)
+          entries.emplace_back(rowIdx ^ xMasks[g], value);
+      }
+      std::sort(entries.begin(), entries.end(),
+                [](auto &a, auto &b) { return a.first < b.first; });
+      for (std::size_t e = 0; e < entries.size(); e++) {
+        rowColumns[rowIdx * nGroups + e] = entries[e].first;
+        rowValues[rowIdx * nGroups + e] = entries[e].second;
+      }
+      rowOffsets[rowIdx + 1] = entries.size();
+    }
+  }
+
+  // Compact the rows.
+  for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++)
+    rowOffsets[rowIdx + 1] += rowOffsets[rowIdx];
+  std::vector<std::complex<double>> values(rowOffsets[dim]);
+  std::vector<std::size_t> columns(rowOffsets[dim]);
   for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
-    auto rowBitStr = getBitStrForIdx(rowIdx);
-    for_each_term([&](spin_op &term) {
-      auto [res, coeff] = actionOnBra(term, rowBitStr);
-      auto colIdx = std::stol(res, nullptr, 2);
-      rawData[rowIdx * dim + colIdx] += coeff;
-    });
+    const auto count = rowOffsets[rowIdx + 1] - rowOffsets[rowIdx];
+    std::copy_n(rowValues.begin() + rowIdx * nGroups, count,
+                values.begin() + rowOffsets[rowIdx]);
+    std::copy_n(rowColumns.begin() + rowIdx * nGroups, count,
+                columns.begin() + rowOffsets[rowIdx]);
   }
-  return A;
+  return {std::move(values), std::move(columns), std::move(rowOffsets)};
+}
+
+std::vector<std::complex<double>>
+spin_op::apply(const std::vector<std::complex<double>> &vector) const {
+  const auto masks = getIndexMasks();
+  const std::size_t dim = 1ULL << m_n_qubits;
+  if (vector.size() != dim)
+    throw std::runtime_error(
+        "Invalid vector size for spin_op::apply, expected " +
+        std::to_string(dim) + " elements, got " +
+        std::to_string(vector.size()) + ".");
+
+  // Every row is a gather of one element per term, the rows are
+  // independent.
+  std::vector<std::complex<double>> result(dim);
+#pragma omp parallel for
+  for (std::size_t rowIdx = 0; rowIdx < dim; rowIdx++) {
+    std::complex<double> sum = 0.0;
+    for (auto &[xMask, zMask, coeff] : masks) {
+      const auto product = coeff * vector[rowIdx ^ xMask];
+      sum += std::popcount(rowIdx & zMask) % 2 ? -product : product;
+    }
+    result[rowIdx] = sum;
+  }
+  return result;
 }
 
 void spin_op::for_each_term(std::function<void(spin_op &)> &&functor) const {
@@ -94,120 +179,290 @@ void spin_op::for_each_pauli(
     throw std::runtime_error(
         "spin_op::for_each_pauli on valid for spin_op with n_terms == 1.");
 
-  auto nQ = n_qubits();
-  auto bsf = get_bsf()[0];
-  for (std::size_t i = 0; i < nQ; i++) {
-    if (bsf[i] && bsf[i + nQ]) {
-      functor(pauli::Y, i);
-    } else if (bsf[i]) {
-      functor(pauli::X, i);
-    } else if (bsf[i + nQ]) {
-      functor(pauli::Z, i);
-    } else {
-      functor(pauli::I, i);
-    }
+  for (std::size_t i = 0; i < m_n_qubits; i++)
+    functor(getPauli(0, i), i);
+}
+
+namespace {
+/// @brief Products of at least this many pairs of terms are computed with
+/// one partial result per OpenMP thread.
+constexpr std::size_t ParallelProductMinPairs = 1 << 16;
+
+/// @brief The maximum number of terms reserved up front for a product.
+constexpr std::size_t ProductReserveLimit = 1 << 20;
+
+/// @brief Return the number of 64 bit words needed for nQubits bits.
+std::size_t getNumWords(std::size_t nQubits) { return (nQubits + 63) / 64; }
+
+/// @brief Hash the given packed term of nWords words.
+std::uint64_t hashTerm(const std::uint64_t *term, std::size_t nWords) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (std::size_t k = 0; k < nWords; k++) {
+    auto word = term[k] + 0x9e3779b97f4a7c15ULL;
+    word = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    word = (word ^ (word >> 27)) * 0x94d049bb133111ebULL;
+    hash = (hash ^ word ^ (word >> 31)) * 0x100000001b3ULL;
   }
+  return hash;
 }
 
+/// @brief Multiply the packed terms a and b (X words first, then Z words,
+/// nWords each) and write the product term to result. Writing each term as
+/// i^{|x & z|} X^x Z^z, the product is
+/// i^{|xa & za| + |xb & zb| - |xr & zr| + 2 |za & xb|} X^xr Z^zr,
+/// return that power of i modulo 4.
+unsigned multiplyTerms(const std::uint64_t *a, const std::uint64_t *b,
+                       std::uint64_t *result, std::size_t nWords) {
+  long phase = 0;
+  for (std::size_t k = 0; k < nWords; k++) {
+    auto xa = a[k], za = a[k + nWords], xb = b[k], zb = b[k + nWords];
+    auto xr = xa ^ xb, zr = za ^ zb;
+    phase += std::popcount(xa & za) + std::popcount(xb & zb) -
+             std::popcount(xr & zr) + 2 * std::popcount(za & xb);
+    result[k] = xr;
+    result[k + nWords] = zr;
+  }
+  return static_cast<unsigned>(((phase % 4) + 4) % 4);
+}
+
+/// @brief Return true if the packed terms a and b commute, i.e. if the
+/// symplectic inner product |xa & zb| + |za & xb| is even.
+bool termsCommute(const std::uint64_t *a, const std::uint64_t *b,
+                  std::size_t nWords) {
+  std::uint64_t parity = 0;
+  for (std::size_t k = 0; k < nWords; k++)
+    parity ^= (a[k] & b[k + nWords]) ^ (a[k + nWords] & b[k]);
+  return std::popcount(parity) % 2 == 0;
+}
+
+/// @brief Copy the packed term of srcWords words per half into dst, which
+/// has dstWords >= srcWords words per half, zero padding the extra words.
+void copyTerm(const std::uint64_t *src, std::size_t srcWords,
+              std::uint64_t *dst, std::size_t dstWords) {
+  std::fill_n(dst, 2 * dstWords, 0);
+  std::copy_n(src, srcWords, dst);
+  std::copy_n(src + srcWords, srcWords, dst + dstWords);
+}
+} // namespace
+
 spin_op spin_op::random(std::size_t nQubits, std::size_t nTerms) {
+  // Every random term has exactly nQubits of its 2 * nQubits bits set, make
+  // sure we can actually produce nTerms unique terms.
+  if (2 * nQubits < 64) {
+    std::uint64_t nUnique = 1;
+    for (std::size_t k = 1; k <= nQubits; k++)
+      nUnique = nUnique * (nQubits + k) / k;
+    if (nTerms > nUnique)
+      throw std::runtime_error("Cannot create " + std::to_string(nTerms) +
+                               " unique random terms on " +
+                               std::to_string(nQubits) + " qubits.");
+  }
+
   std::random_device rd;
   std::mt19937 gen(rd());
-  std::vector<std::complex<double>> coeff(nTerms, 1.0);
-  std::vector<std::vector<bool>> randomTerms;
-  for (std::size_t i = 0; i < nTerms; i++) {
-    std::vector<bool> termData(2 * nQubits);
+  spin_op op(nQubits, nTerms);
+  std::vector<bool> termData(2 * nQubits);
+  std::vector<std::uint64_t> packed(2 * op.m_n_words);
+  while (op.n_terms() < nTerms) {
+    std::fill(termData.begin(), termData.end(), false);
     std::fill_n(termData.begin(), termData.size() * (1 - .5), 1);
     std::shuffle(termData.begin(), termData.end(), gen);
-    randomTerms.push_back(termData);
+    std::fill(packed.begin(), packed.end(), 0);
+    for (std::size_t i = 0; i < 2 * nQubits; i++)
+      if (termData[i]) {
+        auto bit = i < nQubits ? i : i - nQubits;
+        auto offset = i < nQubits ? 0 : op.m_n_words;
+        packed[offset + bit / 64] |= 1ULL << (bit % 64);
+      }
+    if (op.findTerm(packed.data(), hashTerm(packed.data(), 2 * op.m_n_words)) ==
+        op.n_terms())
+      op.addTerm(packed.data(), 1.0);
   }
 
-  return cudaq::spin_op::from_binary_symplectic(randomTerms, coeff);
+  return op;
+}
+
+pauli spin_op::getPauli(std::size_t termIdx, std::size_t qubit) const {
+  auto term = getTermData(termIdx);
+  auto mask = 1ULL << (qubit % 64);
+  bool x = term[qubit / 64] & mask, z = term[m_n_words + qubit / 64] & mask;
+  if (x && z)
+    return pauli::Y;
+  if (x)
+    return pauli::X;
+  if (z)
+    return pauli::Z;
+  return pauli::I;
+}
+
+std::size_t spin_op::findTerm(const std::uint64_t *term,
+                              std::uint64_t hash) const {
+  if (termIndex.empty())
+    return n_terms();
+  auto mask = termIndex.size() - 1;
+  for (auto pos = hash & mask; termIndex[pos].second; pos = (pos + 1) & mask) {
+    auto &[existingHash, slot] = termIndex[pos];
+    if (existingHash == hash &&
+        std::equal(term, term + 2 * m_n_words, getTermData(slot - 1)))
+      return slot - 1;
+  }
+  return n_terms();
+}
+
+void spin_op::indexTerm(std::uint64_t hash, std::size_t slot) {
+  auto mask = termIndex.size() - 1;
+  auto pos = hash & mask;
+  while (termIndex[pos].second)
+    pos = (pos + 1) & mask;
+  termIndex[pos] = {hash, slot + 1};
+}
+
+std::size_t spin_op::addTerm(const std::uint64_t *term,
+                             std::complex<double> coeff) {
+  auto hash = hashTerm(term, 2 * m_n_words);
+  auto slot = findTerm(term, hash);
+  if (slot != n_terms()) {
+    coefficients[slot] += coeff;
+    return slot;
+  }
+
+  data.insert(data.end(), term, term + 2 * m_n_words);
+  coefficients.push_back(coeff);
+  // Keep the load factor of the index at most 1/2.
+  if (2 * n_terms() > termIndex.size())
+    rebuildIndex(2 * n_terms());
+  else
+    indexTerm(hash, slot);
+  return slot;
+}
+
+void spin_op::rebuildIndex(std::size_t nTermsHint) {
+  auto size =
+      std::bit_ceil(2 * std::max({n_terms(), nTermsHint, std::size_t(8)}));
+  termIndex.assign(size, {0, 0});
+  for (std::size_t i = 0; i < n_terms(); i++)
+    indexTerm(hashTerm(getTermData(i), 2 * m_n_words), i);
+}
+
+void spin_op::removeZeroTerms(double tolerance) {
+  auto termSize = 2 * m_n_words;
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < n_terms(); i++) {
+    if (std::abs(coefficients[i]) < tolerance)
+      continue;
+    if (kept != i) {
+      std::copy_n(data.begin() + i * termSize, termSize,
+                  data.begin() + kept * termSize);
+      coefficients[kept] = coefficients[i];
+    }
+    kept++;
+  }
+
+  if (kept == n_terms())
+    return;
+
+  data.resize(kept * termSize);
+  coefficients.resize(kept);
+  rebuildIndex();
+}
+
+std::vector<std::uint64_t>
+spin_op::getPaddedTermData(std::size_t nWords) const {
+  if (nWords == m_n_words)
+    return data;
+  std::vector<std::uint64_t> padded(2 * nWords * n_terms());
+  for (std::size_t i = 0; i < n_terms(); i++)
+    copyTerm(getTermData(i), m_n_words, padded.data() + 2 * nWords * i,
+             nWords);
+  return padded;
 }
 
 void spin_op::expandToNQubits(const std::size_t n_q) {
-  for (auto &row : data) {
-    std::vector<bool> tmp(n_q * 2);
-    for (std::size_t k = 0; k < m_n_qubits; k++)
-      if (row[k] && row[k + m_n_qubits]) {
-        tmp[k] = 1;
-        tmp[k + n_q] = 1;
-      } else if (row[k])
-        tmp[k] = row[k];
-      else if (row[k + m_n_qubits])
-        tmp[k + n_q] = true;
-    row = tmp;
+  auto nWords = getNumWords(n_q);
+  if (nWords != m_n_words) {
+    std::vector<std::uint64_t> expanded(2 * nWords * n_terms());
+    for (std::size_t i = 0; i < n_terms(); i++)
+      copyTerm(getTermData(i), m_n_words, expanded.data() + 2 * nWords * i,
+               nWords);
+    data = std::move(expanded);
+    m_n_words = nWords;
+    rebuildIndex();
   }
   m_n_qubits = n_q;
 }
 
-spin_op::spin_op() {
-  coefficients.push_back(1.0);
-  // Should initialize with 2 elements for a 1 qubit Identity.
-  data.push_back(std::vector<bool>(2));
-}
+spin_op::spin_op() : data(2), coefficients{1.0} { rebuildIndex(); }
 
-spin_op::spin_op(BinarySymplecticForm d,
-                 std::vector<std::complex<double>> coeffs)
-    : data(d), coefficients(coeffs) {
-  m_n_qubits = data[0].size() / 2.;
+spin_op::spin_op(std::size_t nQubits, std::size_t nTermsHint)
+    : m_n_qubits(nQubits), m_n_words(getNumWords(nQubits)) {
+  data.reserve(2 * m_n_words * nTermsHint);
+  coefficients.reserve(nTermsHint);
+  rebuildIndex(nTermsHint);
 }
 
-spin_op::spin_op(pauli type, const std::size_t idx,
-                 std::complex<double> coeff) {
-  m_n_qubits = idx + 1;
-  [[maybe_unused]] int p = 0;
-  data.push_back(std::vector<bool>(2 * m_n_qubits));
-  if (type == pauli::X) {
-    data.back()[idx] = true;
-  } else if (type == pauli::Y) {
-    p++;
-    data.back()[idx] = true;
-    data.back()[idx + m_n_qubits] = true;
-  } else if (type == pauli::Z) {
-    data.back()[idx + m_n_qubits] = true;
+spin_op::spin_op(const BinarySymplecticForm &d,
+                 const std::vector<std::complex<double>> &coeffs)
+    : spin_op(d[0].size() / 2, d.size()) {
+  if (d.size() != coeffs.size())
+    throw std::runtime_error("Invalid binary symplectic data, number of terms "
+                             "and number of coefficients do not match.");
+
+  std::vector<std::uint64_t> packed(2 * m_n_words);
+  for (std::size_t t = 0; t < d.size(); t++) {
+    const auto &row = d[t];
+    if (row.size() != 2 * m_n_qubits)
+      throw std::runtime_error("Invalid binary symplectic data, all terms must "
+                               "be on the same number of qubits.");
+    std::fill(packed.begin(), packed.end(), 0);
+    for (std::size_t i = 0; i < m_n_qubits; i++) {
+      if (row[i])
+        packed[i / 64] |= 1ULL << (i % 64);
+      if (row[i + m_n_qubits])
+        packed[m_n_words + i / 64] |= 1ULL << (i % 64);
+    }
+    addTerm(packed.data(), coeffs[t]);
   }
+}
 
-  coefficients.push_back(coeff);
+spin_op::spin_op(pauli type, const std::size_t idx, std::complex<double> coeff)
+    : spin_op(idx + 1, 1) {
+  std::vector<std::uint64_t> packed(2 * m_n_words);
+  auto mask = 1ULL << (idx % 64);
+  if (type == pauli::X || type == pauli::Y)
+    packed[idx / 64] |= mask;
+  if (type == pauli::Z || type == pauli::Y)
+    packed[m_n_words + idx / 64] |= mask;
+
+  addTerm(packed.data(), coeff);
 }
 
 spin_op::spin_op(const spin_op &o)
-    : data(o.data), coefficients(o.coefficients), m_n_qubits(o.m_n_qubits) {}
+    : data(o.data), coefficients(o.coefficients), termIndex(o.termIndex),
+      m_n_qubits(o.m_n_qubits), m_n_words(o.m_n_words) {}
 
 spin_op &spin_op::operator+=(const spin_op &v) noexcept {
-  spin_op tmpv = v;
+  if (this == &v)
+    return operator*=(2.0);
+
   if (v.m_n_qubits > m_n_qubits) {
     // If we are adding a op that has more qubits than we do
-    // then we need to resize, making sure to ensure the
-    // correct 1/0 positions.
+    // then we need to resize.
     expandToNQubits(v.m_n_qubits);
-  } else if (v.m_n_qubits < m_n_qubits) {
-    tmpv.expandToNQubits(m_n_qubits);
   }
 
-  // Add the rows from v to this, if
-  // the row already exists, we should just add the coeffs
-  for (auto [i, row] : enumerate(tmpv.data)) {
-    auto it = std::find(data.begin(), data.end(), row);
-    if (it != data.end()) {
-      auto idx = std::distance(data.begin(), it);
-      coefficients[idx] += tmpv.coefficients[i];
-    } else {
-      data.push_back(row);
-      coefficients.push_back(tmpv.coefficients[i]);
-    }
+  // Add the terms from v to this, if the term already
+  // exists, we just add the coefficients. Only the terms
+  // we touch can have become zero.
+  std::vector<std::uint64_t> term(2 * m_n_words);
+  bool hasZeros = false;
+  for (std::size_t i = 0; i < v.n_terms(); i++) {
+    copyTerm(v.getTermData(i), v.m_n_words, term.data(), m_n_words);
+    auto slot = addTerm(term.data(), v.coefficients[i]);
+    hasZeros |= std::abs(coefficients[slot]) < 1e-12;
   }
 
-  // mark any rows for deletion if coeff = (0,0)
-  std::vector<int> marked;
-  for (std::size_t i = 0; i < data.size(); i++)
-    if (std::abs(coefficients[i]) < 1e-12)
-      marked.push_back(i);
-
-  std::sort(marked.begin(), marked.end(), std::greater<int>());
-  for (auto m : marked) {
-    data.erase(data.begin() + m);
-    coefficients.erase(coefficients.begin() + m);
-  }
+  if (hasZeros)
+    removeZeroTerms();
 
   return *this;
 }
@@ -217,11 +472,9 @@ std::vector<std::complex<double>> spin_op::get_coefficients() const {
 }
 
 spin_op spin_op::operator[](const std::size_t term_idx) const {
-  std::vector<bool> term_data = data[term_idx];
-  auto term_coeff = coefficients[term_idx];
-  BinarySymplecticForm f{term_data};
-  std::vector<std::complex<double>> c{term_coeff};
-  return spin_op(f, c);
+  spin_op term(m_n_qubits, 1);
+  term.addTerm(getTermData(term_idx), coefficients[term_idx]);
+  return term;
 }
 
 spin_op &spin_op::operator-=(const spin_op &v) noexcept {
@@ -229,93 +482,152 @@ spin_op &spin_op::operator-=(const spin_op &v) noexcept {
 }
 
 spin_op &spin_op::operator*=(const spin_op &v) noexcept {
-  spin_op copy = v;
-  if (v.m_n_qubits > m_n_qubits) {
-    // If we are adding a op that has more qubits than we do
-    // then we need to resize, making sure to ensure the
-    // correct 1/0 positions.
-    expandToNQubits(v.m_n_qubits);
-  } else if (v.m_n_qubits < m_n_qubits) {
-    copy.expandToNQubits(m_n_qubits);
+  // Multiply every pair of terms, accumulating the products through the term
+  // index of a partial result per thread. Both operands are padded to the
+  // result width once, the inner loop only multiplies and hashes words.
+  auto nQubits = std::max(m_n_qubits, v.m_n_qubits);
+  auto nWords = getNumWords(nQubits);
+  auto aData = getPaddedTermData(nWords), bData = v.getPaddedTermData(nWords);
+  const std::size_t nTermsA = n_terms(), nTermsB = v.n_terms();
+  const std::size_t nPairs = nTermsA * nTermsB;
+  const std::complex<double> iPowers[] = {
+      1.0, std::complex<double>(0, 1), -1.0, std::complex<double>(0, -1)};
+
+  int nThreads = 1;
+#ifdef CUDAQ_HAS_OPENMP
+  if (nPairs >= ParallelProductMinPairs)
+    nThreads = omp_get_max_threads();
+#endif
+  std::vector<spin_op> partials;
+  for (int t = 0; t < nThreads; t++)
+    partials.emplace_back(
+        spin_op(nQubits, std::min(nPairs / nThreads, ProductReserveLimit)));
+
+#pragma omp parallel for num_threads(nThreads) schedule(static)
+  for (std::size_t i = 0; i < nTermsA; i++) {
+#ifdef CUDAQ_HAS_OPENMP
+    auto &partial = partials[omp_get_thread_num()];
+#else
+    auto &partial = partials[0];
+#endif
+    std::vector<std::uint64_t> prod(2 * nWords);
+    auto a = aData.data() + 2 * nWords * i;
+    for (std::size_t j = 0; j < nTermsB; j++) {
+      auto b = bData.data() + 2 * nWords * j;
+      auto phase = multiplyTerms(a, b, prod.data(), nWords);
+      partial.addTerm(prod.data(),
+                      iPowers[phase] * coefficients[i] * v.coefficients[j]);
+    }
   }
 
-  int counter = 0;
-  for (auto &row : data) {
-    int inner_counter = 0;
-    for (auto &other_row : copy.data) {
-      // This is term * otherTerm
-      std::vector<bool> tmp(2 * m_n_qubits), tmp2(2 * m_n_qubits);
-      for (std::size_t i = 0; i < 2 * m_n_qubits; i++)
-        tmp[i] = row[i] ^ other_row[i];
+  spin_op result = std::move(partials[0]);
+  for (std::size_t t = 1; t < partials.size(); t++)
+    for (std::size_t i = 0; i < partials[t].n_terms(); i++)
+      result.addTerm(partials[t].getTermData(i), partials[t].coefficients[i]);
+  result.removeZeroTerms();
 
-      for (std::size_t i = 0; i < m_n_qubits; i++)
-        tmp2[i] = row[i] && other_row[m_n_qubits + i];
+  *this = std::move(result);
+  return *this;
+}
 
-      int orig_phase = 0, other_phase = 0;
-      for (std::size_t i = 0; i < m_n_qubits; i++) {
-        if (row[i] && row[i + m_n_qubits])
-          orig_phase++;
+bool spin_op::is_identity() const {
+  return std::all_of(data.begin(), data.end(),
+                     [](std::uint64_t word) { return word == 0; });
+}
 
-        if (other_row[i] && other_row[i + m_n_qubits])
-          other_phase++;
-      }
+bool spin_op::term_view::is_identity() const {
+  return std::all_of(x_words(), x_words() + 2 * n_words(),
+                     [](std::uint64_t word) { return word == 0; });
+}
 
-      auto _phase = orig_phase + other_phase;
-      int sum = 0;
-      for (auto a : tmp2)
-        if (a)
-          sum++;
-
-      _phase += 2 * sum;
-      // Based on the phase, figure out an extra coeff to apply
-      for (std::size_t i = 0; i < m_n_qubits; i++)
-        if (tmp[i] && tmp[i + m_n_qubits])
-          _phase -= 1;
-
-      _phase %= 4;
-      std::complex<double> imaginary(0, 1);
-      std::map<int, std::complex<double>> phase_coeff_map{
-          {0, 1.0}, {1, -1. * imaginary}, {2, -1.0}, {3, imaginary}};
-      auto phase_coeff = phase_coeff_map[_phase];
-      coefficients[counter] *= phase_coeff * copy.coefficients[inner_counter];
-      inner_counter++;
-      row = tmp;
+const std::string &spin_op::term_view::to_string() const {
+  if (hasKey)
+    return key;
+
+  // Indexed by x + 2 * z.
+  constexpr char pauliChars[] = {'I', 'X', 'Z', 'Y'};
+  auto xWords = x_words(), zWords = z_words();
+  key.clear();
+  char digits[20];
+  for (std::size_t q = 0; q < n_qubits(); q++) {
+    auto x = (xWords[q / 64] >> (q % 64)) & 1;
+    auto z = (zWords[q / 64] >> (q % 64)) & 1;
+    key.push_back(pauliChars[x + 2 * z]);
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), q);
+    key.append(digits, end);
+  }
+  hasKey = true;
+  return key;
+}
+
+bool spin_op::commutes_with(const spin_op &other) const {
+  auto nWords = std::max(m_n_words, other.m_n_words);
+  std::vector<std::uint64_t> a(2 * nWords), b(2 * nWords);
+  for (std::size_t i = 0; i < n_terms(); i++) {
+    copyTerm(getTermData(i), m_n_words, a.data(), nWords);
+    for (std::size_t j = 0; j < other.n_terms(); j++) {
+      copyTerm(other.getTermData(j), other.m_n_words, b.data(), nWords);
+      if (!termsCommute(a.data(), b.data(), nWords))
+        return false;
     }
-    counter++;
   }
-  return *this;
+  return true;
 }
 
-bool spin_op::is_identity() const {
-  for (auto &row : data)
-    for (auto e : row)
-      if (e)
+std::vector<spin_op> spin_op::group_qubit_wise_commuting() const {
+  // Visit the terms with the largest support first, these are
+  // the hardest to place.
+  std::vector<std::size_t> order(n_terms()), weights(n_terms());
+  for (std::size_t i = 0; i < n_terms(); i++) {
+    auto term = getTermData(i);
+    for (std::size_t k = 0; k < m_n_words; k++)
+      weights[i] += std::popcount(term[k] | term[k + m_n_words]);
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+    return weights[a] > weights[b];
+  });
+
+  // The measurement basis of each group, packed like the terms. A term
+  // fits a group if both act with the same Pauli on their common support.
+  std::vector<std::uint64_t> bases;
+  std::vector<spin_op> groups;
+  auto fits = [&](const std::uint64_t *basis, const std::uint64_t *term) {
+    for (std::size_t k = 0; k < m_n_words; k++) {
+      auto bx = basis[k], bz = basis[k + m_n_words];
+      auto tx = term[k], tz = term[k + m_n_words];
+      if (((bx ^ tx) | (bz ^ tz)) & (bx | bz) & (tx | tz))
         return false;
+    }
+    return true;
+  };
 
-  return true;
+  for (auto i : order) {
+    auto term = getTermData(i);
+    std::size_t g = 0;
+    while (g < groups.size() && !fits(&bases[2 * m_n_words * g], term))
+      g++;
+
+    if (g == groups.size()) {
+      bases.insert(bases.end(), term, term + 2 * m_n_words);
+      groups.emplace_back(spin_op(m_n_qubits, 1));
+    } else {
+      auto basis = &bases[2 * m_n_words * g];
+      for (std::size_t k = 0; k < 2 * m_n_words; k++)
+        basis[k] |= term[k];
+    }
+    groups[g].addTerm(term, coefficients[i]);
+  }
+
+  return groups;
 }
 
 bool spin_op::operator==(const spin_op &v) const noexcept {
   // Could be that the term is identity with all zeros
-  bool isId1 = true, isId2 = true;
-  for (auto &row : data)
-    for (auto e : row)
-      if (e) {
-        isId1 = false;
-        break;
-      }
-
-  for (auto &row : v.data)
-    for (auto e : row)
-      if (e) {
-        isId2 = false;
-        break;
-      }
-
-  if (isId1 && isId2)
+  if (is_identity() && v.is_identity())
     return true;
 
-  return data == v.data;
+  return m_n_qubits == v.m_n_qubits && data == v.data;
 }
 
 spin_op &spin_op::operator*=(const double v) noexcept {
@@ -332,7 +644,7 @@ spin_op &spin_op::operator*=(const std::complex<double> v) noexcept {
 }
 
 std::size_t spin_op::n_qubits() const { return m_n_qubits; }
-std::size_t spin_op::n_terms() const { return data.size(); }
+std::size_t spin_op::n_terms() const { return coefficients.size(); }
 std::complex<double>
 spin_op::get_term_coefficient(const std::size_t idx) const {
   return coefficients[idx];
@@ -345,51 +657,74 @@ spin_op spin_op::slice(const std::size_t startIdx, const std::size_t count) {
                              std::to_string(count) + " terms on spin_op with " +
                              std::to_string(nTerms) + " terms.");
 
-  std::vector<std::complex<double>> newCoeffs;
-  BinarySymplecticForm newData;
+  spin_op sliced(m_n_qubits, count);
   for (std::size_t i = startIdx; i < startIdx + count; ++i) {
-    if (i == data.size())
+    if (i == nTerms)
       break;
-    newData.push_back(data[i]);
-    newCoeffs.push_back(coefficients[i]);
+    sliced.addTerm(getTermData(i), coefficients[i]);
   }
-  return spin_op(newData, newCoeffs);
+  return sliced;
 }
 
-std::string spin_op::to_string(bool printCoeffs) const {
-  if (data.empty())
-    return "";
+spin_op &spin_op::simplify(double tolerance) {
+  removeZeroTerms(tolerance);
+  return *this;
+}
+
+std::vector<std::size_t> spin_op::get_term_costs() const {
+  std::vector<std::size_t> costs(n_terms());
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    auto term = getTermData(t);
+    std::size_t support = 0;
+    for (std::size_t k = 0; k < m_n_words; k++)
+      support += std::popcount(term[k] | term[k + m_n_words]);
+    costs[t] = support ? support + 1 : 0;
+  }
+  return costs;
+}
+
+std::vector<spin_op> spin_op::distribute(std::size_t nParts) const {
+  if (nParts == 0)
+    throw std::runtime_error("Cannot distribute a spin_op into 0 parts.");
+  nParts = std::min(nParts, n_terms());
+
+  // Longest processing time first: visit the terms by decreasing cost and
+  // assign each to the part with the lowest total cost so far.
+  auto costs = get_term_costs();
+  std::vector<std::size_t> order(n_terms());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](auto a, auto b) { return costs[a] > costs[b]; });
+  using Load = std::pair<std::size_t, std::size_t>;
+  std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+  for (std::size_t p = 0; p < nParts; p++)
+    loads.emplace(0, p);
+  std::vector<std::size_t> termPart(n_terms());
+  for (auto t : order) {
+    auto [load, part] = loads.top();
+    loads.pop();
+    termPart[t] = part;
+    // Count every term, such that free terms are spread out as well.
+    loads.emplace(load + std::max<std::size_t>(costs[t], 1), part);
+  }
+
+  std::vector<spin_op> parts;
+  for (std::size_t p = 0; p < nParts; p++)
+    parts.emplace_back(spin_op(m_n_qubits, n_terms() / nParts + 1));
+  for (std::size_t t = 0; t < n_terms(); t++)
+    parts[termPart[t]].addTerm(getTermData(t), coefficients[t]);
+  return parts;
+}
 
-  auto first = data[0];
+std::string spin_op::to_string(bool printCoeffs) const {
   std::stringstream ss;
-  if (printCoeffs)
-    ss << coefficients[0] << " ";
-  for (std::size_t i = 0; i < m_n_qubits; i++) {
-    if (first[i] && first[i + m_n_qubits])
-      ss << "Y" << i;
-    else if (first[i])
-      ss << "X" << i;
-    else if (first[i + m_n_qubits])
-      ss << "Z" << i;
-    else
-      ss << "I" << i;
-  }
-
-  for (std::size_t j = 1; j < data.size(); j++) {
-    ss << " + ";
-    first = data[j];
+  for (std::size_t j = 0; j < n_terms(); j++) {
+    if (j > 0)
+      ss << " + ";
     if (printCoeffs)
       ss << coefficients[j] << " ";
-    for (std::size_t i = 0; i < m_n_qubits; i++) {
-      if (first[i] && first[i + m_n_qubits])
-        ss << "Y" << i;
-      else if (first[i])
-        ss << "X" << i;
-      else if (first[i + m_n_qubits])
-        ss << "Z" << i;
-      else
-        ss << "I" << i;
-    }
+    for (std::size_t i = 0; i < m_n_qubits; i++)
+      ss << pauli_to_str.at(getPauli(j, i)) << i;
   }
 
   return ss.str();
@@ -407,37 +742,62 @@ spin_op::spin_op(std::vector<double> &input_vec, std::size_t nQubits) {
                              "spin_op. Number of data elements is incorrect.");
 
   m_n_qubits = nQubits;
-  for (std::size_t i = 0; i < input_vec.size() - 1; i += m_n_qubits + 2) {
-    std::vector<bool> tmpv(2 * m_n_qubits);
+  m_n_words = getNumWords(nQubits);
+  data.reserve(2 * m_n_words * n_terms);
+  coefficients.reserve(n_terms);
+  rebuildIndex(n_terms);
+  addSerializedTerms(input_vec.data(), n_terms);
+}
+
+void spin_op::addSerializedTerms(const double *termData, std::size_t nTerms) {
+  std::vector<std::uint64_t> packed(2 * m_n_words);
+  for (std::size_t t = 0; t < nTerms; t++, termData += m_n_qubits + 2) {
+    std::fill(packed.begin(), packed.end(), 0);
     for (std::size_t j = 0; j < m_n_qubits; j++) {
       double intPart;
-      if (std::modf(input_vec[j + i], &intPart) != 0.0)
+      if (std::modf(termData[j], &intPart) != 0.0)
         throw std::runtime_error(
             "Invalid pauli data element, must be integer value.");
-
-      int val = (int)input_vec[j + i];
-      if (val == 1) { // X
-        tmpv[j] = 1;
-      } else if (val == 2) { // Z
-        tmpv[j + m_n_qubits] = 1;
-      } else if (val == 3) { // Y
-        tmpv[j + m_n_qubits] = 1;
-        tmpv[j] = 1;
-      }
+      if (termData[j] < 0.0 || termData[j] > 3.0)
+        throw std::runtime_error("Invalid pauli data element " +
+                                 std::to_string(termData[j]) +
+                                 ", must be 0 (I), 1 (X), 2 (Z) or 3 (Y).");
+
+      int val = (int)termData[j];
+      auto mask = 1ULL << (j % 64);
+      if (val == 1 || val == 3) // X or Y
+        packed[j / 64] |= mask;
+      if (val == 2 || val == 3) // Z or Y
+        packed[m_n_words + j / 64] |= mask;
     }
-    data.push_back(tmpv);
-    auto el_real = input_vec[i + m_n_qubits];
-    auto el_imag = input_vec[i + m_n_qubits + 1];
-    coefficients.emplace_back(el_real, el_imag);
+    auto el_real = termData[m_n_qubits];
+    auto el_imag = termData[m_n_qubits + 1];
+    addTerm(packed.data(), {el_real, el_imag});
   }
+
+  // Match the terms of the same spin_op built in memory.
+  removeZeroTerms();
 }
 
-spin_op::BinarySymplecticForm spin_op::get_bsf() const { return data; }
+spin_op::BinarySymplecticForm spin_op::get_bsf() const {
+  BinarySymplecticForm bsf(n_terms(), std::vector<bool>(2 * m_n_qubits));
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    auto term = getTermData(t);
+    for (std::size_t i = 0; i < m_n_qubits; i++) {
+      auto mask = 1ULL << (i % 64);
+      bsf[t][i] = term[i / 64] & mask;
+      bsf[t][i + m_n_qubits] = term[m_n_words + i / 64] & mask;
+    }
+  }
+  return bsf;
+}
 
 spin_op &spin_op::operator=(const spin_op &other) {
   data = other.data;
   coefficients = other.coefficients;
+  termIndex = other.termIndex;
   m_n_qubits = other.m_n_qubits;
+  m_n_words = other.m_n_words;
   return *this;
 }
 
@@ -455,41 +815,165 @@ spin_op z(const std::size_t idx) { return spin_op(pauli::Z, idx); }
 
 std::vector<double> spin_op::getDataRepresentation() {
   std::vector<double> dataVec;
-  int counter = 0;
-  for (auto &term : data) {
-    auto nq = n_qubits();
-    for (std::size_t i = 0; i < nq; i++) {
-      if (term[i] && term[i + nq]) {
+  dataVec.reserve(n_terms() * (m_n_qubits + 2) + 1);
+  for (std::size_t t = 0; t < n_terms(); t++) {
+    for (std::size_t i = 0; i < m_n_qubits; i++) {
+      auto p = getPauli(t, i);
+      if (p == pauli::Y) {
         dataVec.push_back(3.);
-      } else if (term[i]) {
+      } else if (p == pauli::X) {
         dataVec.push_back(1.);
-      } else if (term[i + nq]) {
+      } else if (p == pauli::Z) {
         dataVec.push_back(2.);
       } else {
         dataVec.push_back(0.);
       }
     }
-    dataVec.push_back(coefficients[counter].real());
-    dataVec.push_back(coefficients[counter].imag());
-    counter++;
+    dataVec.push_back(coefficients[t].real());
+    dataVec.push_back(coefficients[t].imag());
   }
   dataVec.push_back(n_terms());
   return dataVec;
 }
 
+namespace {
+/// @brief The header of a packed binary spin_op file. It is followed by
+/// nTerms records of 2 * nWords packed words and the coefficient.
+struct SpinOpFileHeader {
+  char magic[8] = {'C', 'U', 'D', 'A', 'Q', 'S', 'P', '\0'};
+  std::uint32_t version = 1;
+  std::uint32_t nWords = 0;
+  std::uint64_t nQubits = 0;
+  std::uint64_t nTerms = 0;
+};
+static_assert(sizeof(SpinOpFileHeader) % alignof(std::uint64_t) == 0,
+              "The term data must be aligned in the file.");
+
+/// @brief A read-only memory mapping of a whole file.
+struct MappedFile {
+  const char *data = nullptr;
+  std::size_t size = 0;
+
+  MappedFile(const std::string &fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error(fileName + " does not exist.");
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Could not read " + fileName + ".");
+    }
+    size = fileStat.st_size;
+    void *mapped = size ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                        : MAP_FAILED;
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+      throw std::runtime_error("Could not map " + fileName + ".");
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(mapped);
+  }
+  ~MappedFile() { ::munmap(const_cast<char *>(data), size); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+};
+} // namespace
+
 spin_op binary_spin_op_reader::read(const std::string &data_filename) {
-  std::ifstream input(data_filename, std::ios::binary);
-  if (input.fail())
-    throw std::runtime_error(data_filename + " does not exist.");
-
-  input.seekg(0, std::ios_base::end);
-  std::size_t size = input.tellg();
-  input.seekg(0, std::ios_base::beg);
-  std::vector<double> input_vec(size / sizeof(double));
-  input.read((char *)&input_vec[0], size);
-  auto n_terms = (int)input_vec.back();
-  auto nQubits = (input_vec.size() - 2 * n_terms) / n_terms;
-  spin_op s(input_vec, nQubits);
-  return s;
+  std::optional<spin_op> result;
+  read_chunks(data_filename, std::numeric_limits<std::size_t>::max(),
+              [&](spin_op &chunk) { result = std::move(chunk); });
+  if (!result)
+    throw std::runtime_error(data_filename + " does not contain any terms.");
+  return std::move(*result);
+}
+
+void binary_spin_op_reader::read_chunks(
+    const std::string &data_filename, std::size_t chunkSize,
+    const std::function<void(spin_op &)> &functor) {
+  if (chunkSize == 0)
+    throw std::runtime_error("Invalid chunk size 0 for reading a spin_op.");
+  MappedFile file(data_filename);
+  auto invalidFile = [&]() {
+    return std::runtime_error("Invalid spin_op file " + data_filename + ".");
+  };
+
+  SpinOpFileHeader header, expected;
+  if (file.size >= sizeof(header) &&
+      std::memcmp(file.data, expected.magic, sizeof(expected.magic)) == 0) {
+    std::memcpy(&header, file.data, sizeof(header));
+    const std::size_t nWords = getNumWords(header.nQubits);
+    const std::size_t recordSize =
+        2 * nWords * sizeof(std::uint64_t) + sizeof(std::complex<double>);
+    if (header.version != expected.version || header.nWords != nWords ||
+        header.nQubits == 0 ||
+        (file.size - sizeof(header)) / recordSize != header.nTerms ||
+        (file.size - sizeof(header)) % recordSize != 0)
+      throw invalidFile();
+
+    // The bits above nQubits in the last X and Z words must be clear.
+    const std::uint64_t unusedBits =
+        header.nQubits % 64 == 0 ? 0 : ~0ULL << (header.nQubits % 64);
+    const char *record = file.data + sizeof(header);
+    for (std::size_t start = 0; start < header.nTerms; start += chunkSize) {
+      const auto count =
+          std::min<std::size_t>(chunkSize, header.nTerms - start);
+      spin_op chunk(header.nQubits, count);
+      for (std::size_t t = 0; t < count; t++, record += recordSize) {
+        const auto *words = reinterpret_cast<const std::uint64_t *>(record);
+        if ((words[nWords - 1] | words[2 * nWords - 1]) & unusedBits)
+          throw invalidFile();
+        std::complex<double> coeff;
+        std::memcpy(&coeff, record + 2 * nWords * sizeof(std::uint64_t),
+                    sizeof(coeff));
+        chunk.addTerm(words, coeff);
+      }
+      chunk.removeZeroTerms();
+      functor(chunk);
+    }
+    return;
+  }
+
+  // The vector<double> serialized representation, ended by the number of
+  // terms.
+  const auto *doubles = reinterpret_cast<const double *>(file.data);
+  const std::size_t nDoubles = file.size / sizeof(double);
+  if (nDoubles < 1 || file.size % sizeof(double) != 0)
+    throw invalidFile();
+  // Casting a NaN, negative or too large double is undefined, check that
+  // the term count is an integer in [1, nDoubles - 1] first.
+  const double termCount = doubles[nDoubles - 1];
+  double intPart;
+  if (!std::isfinite(termCount) || std::modf(termCount, &intPart) != 0.0 ||
+      termCount < 1.0 || termCount > static_cast<double>(nDoubles - 1))
+    throw invalidFile();
+  const auto nTerms = static_cast<std::size_t>(termCount);
+  if ((nDoubles - 1) % nTerms != 0 || (nDoubles - 1) / nTerms < 3)
+    throw invalidFile();
+  const std::size_t nQubits = (nDoubles - 1) / nTerms - 2;
+  for (std::size_t start = 0; start < nTerms; start += chunkSize) {
+    const auto count = std::min(chunkSize, nTerms - start);
+    spin_op chunk(nQubits, count);
+    chunk.addSerializedTerms(doubles + start * (nQubits + 2), count);
+    functor(chunk);
+  }
+}
+
+void binary_spin_op_writer::write(const spin_op &op,
+                                  const std::string &data_filename) {
+  SpinOpFileHeader header;
+  header.nWords = op.m_n_words;
+  header.nQubits = op.m_n_qubits;
+  header.nTerms = op.n_terms();
+  std::ofstream file(data_filename, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (std::size_t t = 0; t < op.n_terms(); t++) {
+    file.write(reinterpret_cast<const char *>(op.getTermData(t)),
+               2 * op.m_n_words * sizeof(std::uint64_t));
+    file.write(reinterpret_cast<const char *>(&op.coefficients[t]),
+               sizeof(std::complex<double>));
+  }
+  if (!file)
+    throw std::runtime_error("Could not write the spin_op to " +
+                             data_filename + ".");
 }
 } // namespace cudaq
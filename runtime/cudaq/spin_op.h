@@ -11,8 +11,13 @@
 
 #include "matrix.h"
 #include "utils/cudaq_utils.h"
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 // Define friend functions for operations between spin_op and scalars.
 #define CUDAQ_SPIN_SCALAR_OPERATIONS(op, U)                                    \
@@ -80,6 +85,13 @@
 namespace cudaq {
 class spin_op;
 
+/// @brief A sparse matrix in compressed sparse row (CSR) format: the non-zero
+/// values, their column indices, and the offset of the first value of each
+/// row in these (with a final entry equal to the number of values).
+using csr_spmatrix =
+    std::tuple<std::vector<std::complex<double>>, std::vector<std::size_t>,
+               std::vector<std::size_t>>;
+
 /// @brief Utility enum representing Paulis.
 enum class pauli { I, X, Y, Z };
 
@@ -111,6 +123,10 @@ private:
   friend spin_op spin::y(const std::size_t);
   friend spin_op spin::z(const std::size_t);
 
+  /// The file reader and writer work on the packed term data directly.
+  friend class binary_spin_op_reader;
+  friend class binary_spin_op_writer;
+
   /// @brief We represent the spin_op in binary symplectic form,
   /// i.e. each term is a vector of 1s and 0s of size 2 * nQubits,
   /// where the first n elements represent X, the next n elements
@@ -118,15 +134,28 @@ private:
   /// and X=0, Z=1 -> Z on site i.
   using BinarySymplecticForm = std::vector<std::vector<bool>>;
 
-  /// @brief The spin_op representation
-  BinarySymplecticForm data;
+  /// @brief The spin_op representation. Internally the binary symplectic
+  /// form is bit-packed. Each term is stored as 2 * m_n_words contiguous
+  /// 64 bit words, the X words first followed by the Z words, with qubit i
+  /// at bit i % 64 of word i / 64. Terms are stored one after the other.
+  std::vector<std::uint64_t> data;
 
   /// @brief The coefficients for each term in the spin_op
   std::vector<std::complex<double>> coefficients;
 
+  /// @brief Hash index from the packed term to its slot in coefficients,
+  /// used to merge duplicate terms in constant time. This is an open
+  /// addressing table with linear probing, each position holds the term
+  /// hash and the slot + 1 (0 if the position is empty). Its size is a power
+  /// of 2 of at least twice the number of terms.
+  std::vector<std::pair<std::uint64_t, std::size_t>> termIndex;
+
   /// @brief The number of qubits this spin_op is on
   std::size_t m_n_qubits = 1;
 
+  /// @brief The number of 64 bit words in the X (and Z) half of a term.
+  std::size_t m_n_words = 1;
+
   /// @brief Utility map that takes the pauli enum to a string representation
   std::map<pauli, std::string> pauli_to_str{
       {pauli::I, "I"}, {pauli::X, "X"}, {pauli::Y, "Y"}, {pauli::Z, "Z"}};
@@ -135,15 +164,126 @@ private:
   /// a larger number of qubits.
   void expandToNQubits(const std::size_t nQubits);
 
+  /// @brief Return a pointer to the packed words of the given term.
+  const std::uint64_t *getTermData(std::size_t termIdx) const {
+    return data.data() + 2 * m_n_words * termIdx;
+  }
+
+  /// @brief Return the pauli acting on the given qubit in the given term.
+  pauli getPauli(std::size_t termIdx, std::size_t qubit) const;
+
+  /// @brief Return the coefficient slot of the given packed term, or
+  /// n_terms() if the term is not in this spin_op.
+  std::size_t findTerm(const std::uint64_t *term, std::uint64_t hash) const;
+
+  /// @brief Add the coefficient to the given packed term, appending the term
+  /// if it is not yet in this spin_op. Return the term's coefficient slot.
+  std::size_t addTerm(const std::uint64_t *term, std::complex<double> coeff);
+
+  /// @brief Recompute the term hash index from the packed data, with room
+  /// for at least nTermsHint terms.
+  void rebuildIndex(std::size_t nTermsHint = 0);
+
+  /// @brief Insert the given term slot and hash into the term hash index.
+  void indexTerm(std::uint64_t hash, std::size_t slot);
+
+  /// @brief Remove all terms with a coefficient magnitude below the given
+  /// tolerance.
+  void removeZeroTerms(double tolerance = 1e-12);
+
+  /// @brief Return the packed words of all terms, padded to nWords words per
+  /// half (nWords >= m_n_words).
+  std::vector<std::uint64_t> getPaddedTermData(std::size_t nWords) const;
+
+  /// @brief Add the nTerms terms of the vector<double> serialized
+  /// representation starting at termData (see the public constructor for
+  /// the encoding, without the trailing number of terms).
+  void addSerializedTerms(const double *termData, std::size_t nTerms);
+
+  /// @brief Return the X and Z masks of each term over the row index of the
+  /// matrix of this spin_op, where qubit 0 is the most significant bit, and
+  /// the term coefficient times (-i)^{number of Y}, such that the term maps
+  /// row r to column r ^ xMask with the value coefficient * (-1)^{|r & zMask|}.
+  std::vector<std::tuple<std::uint64_t, std::uint64_t, std::complex<double>>>
+  getIndexMasks() const;
+
+  /// @brief Internal constructor, constructs an empty spin_op (no terms) on
+  /// the given number of qubits.
+  explicit spin_op(std::size_t nQubits, std::size_t nTermsHint);
+
   /// @brief Internal constructor, takes the Pauli type, the qubit site, and the
   /// term coefficient. Constructs a spin_op of one pauli on one qubit.
   spin_op(pauli, const std::size_t id, std::complex<double> coeff = 1.0);
 
   /// @brief Internal constructor, constructs from existing binary symplectic
-  /// form data and term coefficients.
-  spin_op(BinarySymplecticForm bsf, std::vector<std::complex<double>> coeffs);
+  /// form data and term coefficients. Duplicate terms are merged.
+  spin_op(const BinarySymplecticForm &bsf,
+          const std::vector<std::complex<double>> &coeffs);
 
 public:
+  /// @brief A non-owning view of one term of a spin_op. It exposes the packed
+  /// X and Z words and the coefficient of the term without copying them into
+  /// a new spin_op. A view is invalidated by any modification of the spin_op
+  /// it was taken from.
+  class term_view {
+  private:
+    friend class spin_op;
+
+    /// @brief The viewed spin_op and term.
+    const spin_op *op;
+    std::size_t termIdx;
+
+    /// @brief The string key of the term, built on first use.
+    mutable std::string key;
+    mutable bool hasKey = false;
+
+    /// @brief Move this view to the next term, keeping the key buffer.
+    void advance() {
+      termIdx++;
+      hasKey = false;
+    }
+
+  public:
+    term_view(const spin_op &op, std::size_t termIdx)
+        : op(&op), termIdx(termIdx) {}
+
+    /// @brief Return the index of this term in its spin_op.
+    std::size_t index() const { return termIdx; }
+
+    /// @brief Return the number of qubits of the spin_op.
+    std::size_t n_qubits() const { return op->m_n_qubits; }
+
+    /// @brief Return the number of 64 bit words of the X (and Z) mask.
+    std::size_t n_words() const { return op->m_n_words; }
+
+    /// @brief Return the packed X mask of this term, qubit i at bit i % 64
+    /// of word i / 64.
+    const std::uint64_t *x_words() const { return op->getTermData(termIdx); }
+
+    /// @brief Return the packed Z mask of this term.
+    const std::uint64_t *z_words() const { return x_words() + n_words(); }
+
+    /// @brief Return the coefficient of this term.
+    std::complex<double> get_coefficient() const {
+      return op->coefficients[termIdx];
+    }
+
+    /// @brief Return the pauli acting on the given qubit.
+    pauli get_pauli(std::size_t qubit) const {
+      return op->getPauli(termIdx, qubit);
+    }
+
+    /// @brief Return true if this term is the identity.
+    bool is_identity() const;
+
+    /// @brief Return the string key of this term, equal to to_string(false)
+    /// of the one-term spin_op. The key is computed once per view.
+    const std::string &to_string() const;
+
+    /// @brief Return this term as a one-term spin_op.
+    spin_op to_spin_op() const { return (*op)[termIdx]; }
+  };
+
   /// @brief Return a new spin_op from the user-provided binary symplectic data.
   static spin_op
   from_binary_symplectic(BinarySymplecticForm &data,
@@ -160,6 +300,9 @@ public:
   /// @brief Copy constructor
   spin_op(const spin_op &o);
 
+  /// @brief Move constructor
+  spin_op(spin_op &&o) = default;
+
   /// @brief Construct this spin_op from a serialized representation.
   /// Specifically, this encoding is via a vector of doubles. The encoding is
   /// as follows: for each term, a list of doubles where the ith element is
@@ -175,6 +318,9 @@ public:
   /// @brief Set the provided spin_op equal to this one and return *this.
   spin_op &operator=(const spin_op &);
 
+  /// @brief Move the provided spin_op into this one and return *this.
+  spin_op &operator=(spin_op &&) = default;
+
   /// @brief Add the given spin_op to this one and return *this
   spin_op &operator+=(const spin_op &v) noexcept;
 
@@ -240,6 +386,18 @@ public:
   /// @brief Is this spin_op == to the identity
   bool is_identity() const;
 
+  /// @brief Return true if every term of this spin_op commutes with every
+  /// term of the given spin_op.
+  bool commutes_with(const spin_op &other) const;
+
+  /// @brief Partition the terms of this spin_op into groups of qubit-wise
+  /// commuting terms, i.e. terms that act with the same Pauli (or the
+  /// identity) on every qubit. All terms of a group can be measured with a
+  /// single measurement circuit. The partitioning is a greedy first-fit
+  /// coloring visiting the terms with the largest support first, it is
+  /// deterministic for a given spin_op.
+  std::vector<spin_op> group_qubit_wise_commuting() const;
+
   /// @brief Dump a string representation of this spin_op to standard out.
   void dump() const;
 
@@ -258,10 +416,40 @@ public:
   /// are the next count terms.
   spin_op slice(const std::size_t startIdx, const std::size_t count);
 
+  /// @brief Remove the terms whose coefficient magnitude is below the given
+  /// tolerance and return *this. Duplicate terms are always merged
+  /// through the term hash index as they are added, so the remaining terms
+  /// are unique.
+  spin_op &simplify(double tolerance = 1e-12);
+
+  /// @brief Return the estimated cost of measuring each term, one plus the
+  /// number of qubits the term acts on (0 for the identity).
+  std::vector<std::size_t> get_term_costs() const;
+
+  /// @brief Partition the terms of this spin_op into at most nParts
+  /// non-empty spin_ops of about equal total estimated cost (see
+  /// get_term_costs), assigning the most expensive terms first to the least
+  /// loaded part. Terms keep their relative order within a part.
+  std::vector<spin_op> distribute(std::size_t nParts) const;
+
   /// @brief Apply the give functor on each term of this spin_op. This method
   /// can enable general reductions via lambda capture variables.
   void for_each_term(std::function<void(spin_op &)> &&) const;
 
+  /// @brief Return a view of the term at the given index.
+  term_view get_term_view(std::size_t termIdx) const {
+    return term_view(*this, termIdx);
+  }
+
+  /// @brief Apply the given functor on a term_view of each term of this
+  /// spin_op. Unlike for_each_term, this does not create a spin_op per term,
+  /// the same view is moved from term to term and reuses its key buffer.
+  template <typename TermFunctor>
+  void for_each_term_view(TermFunctor &&functor) const {
+    for (term_view term(*this, 0); term.termIdx < n_terms(); term.advance())
+      functor(static_cast<const term_view &>(term));
+  }
+
   /// @brief Apply the functor on each pauli in this 1-term spin_op. An
   /// exception is thrown if there are more than 1 terms. Users should pass a
   /// functor that takes the pauli type and the qubit index.
@@ -270,6 +458,16 @@ public:
   /// @brief Return a dense matrix representation of this
   /// spin_op.
   complex_matrix to_matrix() const;
+
+  /// @brief Return a sparse matrix representation of this spin_op, in CSR
+  /// format. Each row has at most one non-zero per distinct X mask of the
+  /// terms, the column indices of a row are sorted.
+  csr_spmatrix to_sparse_matrix() const;
+
+  /// @brief Return the product of the matrix of this spin_op with the given
+  /// vector of dimension 2^n_qubits(), without forming the matrix.
+  std::vector<std::complex<double>>
+  apply(const std::vector<std::complex<double>> &vector) const;
 };
 
 /// @brief Add a double and a spin_op
@@ -290,8 +488,33 @@ public:
   virtual spin_op read(const std::string &data_filename) = 0;
 };
 
+class spin_op_writer {
+public:
+  virtual ~spin_op_writer() = default;
+  virtual void write(const spin_op &op, const std::string &data_filename) = 0;
+};
+
+/// @brief The binary_spin_op_reader reads the packed binary format written
+/// by the binary_spin_op_writer, as well as files holding the vector<double>
+/// serialized representation of spin_op::getDataRepresentation(). The file
+/// is memory mapped and parsed in place.
 class binary_spin_op_reader : public spin_op_reader {
 public:
   spin_op read(const std::string &data_filename) override;
+
+  /// @brief Parse the file in consecutive chunks of at most chunkSize terms,
+  /// and call the functor with each chunk. Only one chunk is held in memory
+  /// at a time, so this can iterate over the terms of an operator that is
+  /// too large to load at once.
+  void read_chunks(const std::string &data_filename, std::size_t chunkSize,
+                   const std::function<void(spin_op &)> &functor);
+};
+
+/// @brief The binary_spin_op_writer writes a spin_op in the packed binary
+/// format: a header with the number of qubits and terms, followed by each
+/// term as its bit-packed X and Z words and its complex coefficient.
+class binary_spin_op_writer : public spin_op_writer {
+public:
+  void write(const spin_op &op, const std::string &data_filename) override;
 };
 } // namespace cudaq
@@ -16,7 +16,8 @@
 
 #include <cstdarg>
 #include <cstddef>
-#include <queue>
+#include <deque>
+#include <exception>
 #include <sstream>
 #include <string>
 
@@ -244,15 +245,72 @@ protected:
     const std::vector<std::complex<ScalarType>> matrix;
     const std::vector<std::size_t> controls;
     const std::vector<std::size_t> targets;
+    const std::vector<ScalarType> parameters;
     GateApplicationTask(const std::string &name,
                         const std::vector<std::complex<ScalarType>> &m,
                         const std::vector<std::size_t> &c,
-                        const std::vector<std::size_t> &t)
-        : operationName(name), matrix(m), controls(c), targets(t) {}
+                        const std::vector<std::size_t> &t,
+                        const std::vector<ScalarType> &p = {})
+        : operationName(name), matrix(m), controls(c), targets(t),
+          parameters(p) {}
   };
 
   /// @brief The current queue of operations to execute
-  std::queue<GateApplicationTask> gateQueue;
+  std::deque<GateApplicationTask> gateQueue;
+
+  /// @brief The maximum number of qubits a fused gate may act on. When
+  /// flushing the gate queue, runs of consecutive gates whose combined
+  /// control and target qubits fit within this limit are multiplied into a
+  /// single dense matrix and applied with one call to applyGate. A value
+  /// less than 2 disables gate fusion. Subtypes opt in by setting this, since
+  /// the fused matrix uses the first target as the most significant bit of
+  /// the matrix index.
+  std::size_t maxFusedQubits = 0;
+
+  /// @brief If true, deallocating the qubit with the highest index traces
+  /// it out of the state, along with any deallocated qubits right below it.
+  /// Deallocated qubits below a live one stay in the state untouched, which
+  /// leaves the live qubits as they would be had the qubit been traced out,
+  /// and are reset to |0> when the next allocation hands them out again. So
+  /// nQubitsAllocated is the number of qubits spanned by the state. Under an
+  /// execution context, only the qubits the context still reads are kept
+  /// until it ends. Subtypes opt in by setting this and implementing
+  /// removeQubitFromState().
+  bool compactStateOnDeallocation = false;
+
+  /// @brief The gates of each kernel invocation of a batched observe task
+  /// (or of an observe-gradient task), recorded instead of applied. Their
+  /// qubits are numbered in the order the invocation allocated them.
+  std::vector<std::vector<GateApplicationTask>> batchCircuits;
+
+  /// @brief The qubits allocated by each kernel invocation of a batched
+  /// observe task.
+  std::vector<std::vector<std::size_t>> batchQubits;
+
+  /// @brief Return true if we are recording the kernel invocations of a
+  /// batched observe task or of an observe-gradient task.
+  bool isBatching() const {
+    return executionContext &&
+           (executionContext->name == "observe-batch" ||
+            executionContext->name == "observe-gradient") &&
+           executionContext->canHandleObserve;
+  }
+
+  /// @brief Return true if the recorded kernel invocations `a` and `b`
+  /// allocated the same number of qubits and applied the same gates on the
+  /// same qubits, their gate parameters may differ.
+  bool haveSameStructure(std::size_t a, std::size_t b) const {
+    if (batchQubits[a].size() != batchQubits[b].size() ||
+        batchCircuits[a].size() != batchCircuits[b].size())
+      return false;
+    for (std::size_t g = 0; g < batchCircuits[a].size(); g++) {
+      const auto &gateA = batchCircuits[a][g], &gateB = batchCircuits[b][g];
+      if (gateA.operationName != gateB.operationName ||
+          gateA.controls != gateB.controls || gateA.targets != gateB.targets)
+        return false;
+    }
+    return true;
+  }
 
   /// @brief Get the name of the current circuit being executed.
   std::string getCircuitName() const { return currentCircuitName; }
@@ -267,6 +325,42 @@ protected:
   /// This is subclass specific.
   virtual void addQubitToState() = 0;
 
+  /// @brief Trace the qubit with the highest index out of the state
+  /// representation. This is subclass specific, see
+  /// compactStateOnDeallocation.
+  virtual void removeQubitFromState() {
+    throw std::runtime_error(
+        "The current backend does not support removing qubits.");
+  }
+
+  /// @brief Remove the trailing deallocated qubits from the state.
+  void compactState() {
+    flushGateQueue();
+    while (nQubitsAllocated > 0 && tracker.isAvailable(nQubitsAllocated - 1)) {
+      removeQubitFromState();
+      nQubitsAllocated--;
+      stateDimension = calculateStateDim(nQubitsAllocated);
+    }
+    cudaq::info("Compacted the state to {} qubits.", nQubitsAllocated);
+  }
+
+  /// @brief Return true if the current execution context may still read the
+  /// given qubit once the kernel is done: a qubit measured by a sample
+  /// context, or any qubit if it has measured none, a qubit of the spin_op of
+  /// an observe context, and any qubit for the other contexts.
+  bool isReadByExecutionContext(const std::size_t qubitIdx) const {
+    if (executionContext->name == "sample") {
+      if (sampleQubits.empty() && midCircuitSampleResults.empty())
+        return true;
+      return std::find(sampleQubits.begin(), sampleQubits.end(), qubitIdx) !=
+             sampleQubits.end();
+    }
+    if (executionContext->name == "observe")
+      return !executionContext->spin.has_value() ||
+             qubitIdx < executionContext->spin.value()->n_qubits();
+    return true;
+  }
+
   /// @brief Subclass specific part of resetQubitState().
   /// It will be invoked by resetQubitState()
   virtual void resetQubitStateImpl() = 0;
@@ -287,10 +381,80 @@ protected:
   /// basis quantum gates to change to the Z basis and sample.
   virtual bool canHandleObserve() { return false; }
 
+  /// @brief Return true if this CircuitSimulator can simulate the recorded
+  /// circuits of a batched observe task with observeBatch().
+  virtual bool canHandleObserveBatch() { return false; }
+
+  /// @brief Return the expectation value of the spin_op for each recorded
+  /// circuit of a batched observe task.
+  virtual std::vector<double> observeBatch(const cudaq::spin_op &op) {
+    throw std::runtime_error("This CircuitSimulator does not implement "
+                             "observeBatch(const cudaq::spin_op &).");
+  }
+
+  /// @brief Return true if this CircuitSimulator can differentiate the
+  /// recorded circuit of an observe-gradient task with observeGradient().
+  virtual bool canHandleObserveGradient() { return false; }
+
+  /// @brief Return the expectation value of the spin_op for the first
+  /// recorded circuit of an observe-gradient task, and its derivatives with
+  /// respect to the parameters of the recorded gates, in order.
+  virtual std::pair<double, std::vector<double>>
+  observeGradient(const cudaq::spin_op &op) {
+    throw std::runtime_error("This CircuitSimulator does not implement "
+                             "observeGradient(const cudaq::spin_op &).");
+  }
+
+  /// @brief Differentiate the recorded circuits of an observe-gradient task,
+  /// storing the results in the execution context. Nothing is stored if the
+  /// kernel invocations did not apply the same gates.
+  void handleObserveGradient() {
+    for (std::size_t b = 1; b < batchCircuits.size(); b++)
+      if (!haveSameStructure(0, b))
+        return;
+
+    auto &parameters = executionContext->batchGateParameters;
+    parameters.resize(batchCircuits.size());
+    for (std::size_t b = 0; b < batchCircuits.size(); b++)
+      for (auto &gate : batchCircuits[b])
+        parameters[b].insert(parameters[b].end(), gate.parameters.begin(),
+                             gate.parameters.end());
+
+    auto [expectationValue, gradients] =
+        observeGradient(*executionContext->spin.value());
+    executionContext->expectationValue = expectationValue;
+    executionContext->gateParameterGradients = std::move(gradients);
+  }
+
   /// @brief Return the internal state representation. This
   /// is meant for subtypes to override
   virtual cudaq::State getStateData() { return {}; }
 
+  /// @brief Return the internal state representation without copying it,
+  /// the returned handle takes the memory over. Only called when the state
+  /// is about to be reset, subtypes that can hand their memory over
+  /// override this, an empty handle means getStateData() is used instead.
+  virtual cudaq::StateHandle releaseStateData() { return {}; }
+
+  /// @brief Return the amplitudes of the given basis states, one character
+  /// per qubit with qubit 0 first, without extracting the whole state.
+  virtual std::vector<std::complex<double>>
+  getAmplitudes(const std::vector<std::string> &bitStrings) {
+    throw std::runtime_error(
+        "This CircuitSimulator does not implement "
+        "getAmplitudes(const std::vector<std::string> &).");
+  }
+
+  /// @brief Return the probability of each outcome of measuring the given
+  /// qubits (all qubits if empty), without extracting the whole state. The
+  /// first qubit is the most significant bit of the outcome index.
+  virtual std::vector<double>
+  getProbabilities(const std::vector<std::size_t> &qubits) {
+    throw std::runtime_error(
+        "This CircuitSimulator does not implement "
+        "getProbabilities(const std::vector<std::size_t> &).");
+  }
+
   /// @brief Handle basic sampling tasks by storing the qubit index for
   /// processing in resetExecutionContext. Return true to indicate this is
   /// sampling and to exit early. False otherwise.
@@ -452,8 +616,29 @@ protected:
   void enqueueGate(const std::string name,
                    const std::vector<std::complex<ScalarType>> &matrix,
                    const std::vector<std::size_t> &controls,
-                   const std::vector<std::size_t> &targets) {
-    gateQueue.emplace(name, matrix, controls, targets);
+                   const std::vector<std::size_t> &targets,
+                   const std::vector<ScalarType> &parameters = {}) {
+    if (isBatching()) {
+      // Record the gate on the qubits of the current kernel invocation.
+      auto &qubits = batchQubits[executionContext->batchIndex];
+      auto toPositions = [&](const std::vector<std::size_t> &ids) {
+        std::vector<std::size_t> positions;
+        for (auto id : ids) {
+          auto iter = std::find(qubits.begin(), qubits.end(), id);
+          if (iter == qubits.end())
+            throw std::runtime_error("Batched observe kernels can only act on "
+                                     "the qubits they allocate.");
+          positions.push_back(std::distance(qubits.begin(), iter));
+        }
+        return positions;
+      };
+      batchCircuits[executionContext->batchIndex].emplace_back(
+          name, matrix, toPositions(controls), toPositions(targets),
+          parameters);
+      return;
+    }
+
+    gateQueue.emplace_back(name, matrix, controls, targets, parameters);
   }
 
   /// @brief This pure virtual method is meant for subtypes
@@ -470,9 +655,117 @@ protected:
   virtual void applyNoiseChannel(const std::string_view gateName,
                                  const std::vector<std::size_t> &qubits) {}
 
+  /// @brief Multiply the given gates, in order, into a single dense gate
+  /// acting on `qubits`. The first qubit is the most significant bit of the
+  /// fused matrix index, controls of the individual gates are folded into
+  /// the matrix.
+  GateApplicationTask fuseGates(const std::vector<GateApplicationTask> &gates,
+                                const std::vector<std::size_t> &qubits) {
+    const std::size_t nQubits = qubits.size();
+    const std::size_t dim = 1ULL << nQubits;
+    auto bitOf = [&](std::size_t qubit) {
+      auto iter = std::find(qubits.begin(), qubits.end(), qubit);
+      return nQubits - 1 - std::distance(qubits.begin(), iter);
+    };
+
+    // Start from the identity, and left-multiply each gate.
+    std::vector<std::complex<ScalarType>> fused(dim * dim, 0.0);
+    for (std::size_t i = 0; i < dim; i++)
+      fused[i * dim + i] = 1.0;
+
+    std::vector<std::complex<ScalarType>> local;
+    for (auto &gate : gates) {
+      std::size_t controlMask = 0, targetMask = 0;
+      for (auto c : gate.controls)
+        controlMask |= 1ULL << bitOf(c);
+
+      // Offset of each local gate matrix index in the fused matrix index.
+      const std::size_t nTargets = gate.targets.size();
+      const std::size_t gateDim = 1ULL << nTargets;
+      std::vector<std::size_t> offsets(gateDim, 0);
+      for (std::size_t j = 0; j < nTargets; j++) {
+        const std::size_t bit = 1ULL << bitOf(gate.targets[j]);
+        targetMask |= bit;
+        for (std::size_t m = 0; m < gateDim; m++)
+          if (m & (1ULL << (nTargets - 1 - j)))
+            offsets[m] |= bit;
+      }
+
+      // Apply the gate to every column of the fused matrix.
+      local.resize(gateDim);
+      for (std::size_t col = 0; col < dim; col++)
+        for (std::size_t base = 0; base < dim; base++) {
+          if ((base & controlMask) != controlMask || (base & targetMask))
+            continue;
+          for (std::size_t m = 0; m < gateDim; m++)
+            local[m] = fused[(base | offsets[m]) * dim + col];
+          for (std::size_t r = 0; r < gateDim; r++) {
+            std::complex<ScalarType> sum = 0.0;
+            for (std::size_t m = 0; m < gateDim; m++)
+              sum += gate.matrix[r * gateDim + m] * local[m];
+            fused[(base | offsets[r]) * dim + col] = sum;
+          }
+        }
+    }
+
+    return GateApplicationTask("fused", fused, {}, qubits);
+  }
+
+  /// @brief Flush the gate queue, greedily grouping consecutive gates into
+  /// blocks acting on at most maxFusedQubits qubits and applying each block
+  /// as a single fused gate.
+  void flushFusedGateQueue() {
+    std::vector<GateApplicationTask> block;
+    std::vector<std::size_t> blockQubits;
+    auto applyBlock = [&]() {
+      if (block.size() == 1)
+        applyGate(block.front());
+      else if (!block.empty())
+        applyGate(fuseGates(block, blockQubits));
+      block.clear();
+      blockQubits.clear();
+    };
+
+    while (!gateQueue.empty()) {
+      auto &next = gateQueue.front();
+      std::vector<std::size_t> qubits = blockQubits;
+      auto addQubits = [&](const std::vector<std::size_t> &gateQubits) {
+        for (auto q : gateQubits)
+          if (std::find(qubits.begin(), qubits.end(), q) == qubits.end())
+            qubits.push_back(q);
+      };
+      addQubits(next.controls);
+      addQubits(next.targets);
+
+      if (qubits.size() > maxFusedQubits) {
+        applyBlock();
+        qubits = next.controls;
+        qubits.insert(qubits.end(), next.targets.begin(), next.targets.end());
+      }
+
+      if (qubits.size() > maxFusedQubits) {
+        // Too wide to fuse with anything, apply it on its own.
+        applyGate(next);
+      } else {
+        block.push_back(next);
+        blockQubits = std::move(qubits);
+      }
+      gateQueue.pop_front();
+    }
+    applyBlock();
+  }
+
   /// @brief Flush the gate queue, run all queued gate
-  /// application tasks.
+  /// application tasks. If gate fusion is enabled and there is no
+  /// noise model (which must be applied after every gate), the gates
+  /// are fused before application.
   void flushGateQueueImpl() override {
+    const bool hasNoise = executionContext && executionContext->noiseModel;
+    if (maxFusedQubits > 1 && !hasNoise) {
+      flushFusedGateQueue();
+      return;
+    }
+
     while (!gateQueue.empty()) {
       auto &next = gateQueue.front();
       applyGate(next);
@@ -483,7 +776,7 @@ protected:
                            next.targets.end());
         applyNoiseChannel(next.operationName, noiseQubits);
       }
-      gateQueue.pop();
+      gateQueue.pop_front();
     }
   }
 
@@ -514,9 +807,21 @@ public:
     // Get a new qubit index
     auto newIdx = tracker.getNextIndex();
 
+    // Qubits of a batched observe task are only recorded.
+    if (isBatching()) {
+      batchQubits[executionContext->batchIndex].push_back(newIdx);
+      return newIdx;
+    }
+
     cudaq::info("Allocating new qubit with idx {} (nQ={}, dim={})", newIdx,
                 nQubitsAllocated, stateDimension);
 
+    // A deallocated qubit is still in the compacted state, reuse it in |0>.
+    if (compactStateOnDeallocation && newIdx < nQubitsAllocated) {
+      resetQubit(newIdx);
+      return newIdx;
+    }
+
     // Increment the number of qubits and set
     // the new state dimension
     nQubitsAllocated++;
@@ -540,7 +845,15 @@ public:
 
   /// @brief Deallocate the qubit with give idx
   void deallocate(const std::size_t qubitIdx) override {
-    if (executionContext) {
+    // Qubits of a batched observe task are not in the state, the next
+    // kernel invocation can reuse them.
+    if (isBatching()) {
+      tracker.returnIndex(qubitIdx);
+      return;
+    }
+
+    if (executionContext &&
+        (!compactStateOnDeallocation || isReadByExecutionContext(qubitIdx))) {
       cudaq::info("Deferring qubit {} deallocation", qubitIdx);
       deferredDeallocation.push_back(qubitIdx);
       return;
@@ -548,20 +861,23 @@ public:
 
     cudaq::info("Deallocating qubit {}", qubitIdx);
 
-    // Reset the qubit
-    resetQubit(qubitIdx);
+    // Reset the qubit, a compacted state traces it out instead.
+    if (!compactStateOnDeallocation)
+      resetQubit(qubitIdx);
 
     // Return the index to the tracker
     tracker.returnIndex(qubitIdx);
-    --nQubitsAllocated;
+    if (!compactStateOnDeallocation)
+      --nQubitsAllocated;
 
     // Reset the state if we've deallocated all qubits.
     if (tracker.numAvailable() == tracker.totalNumQubits()) {
       cudaq::info("Deallocated all qubits, reseting state vector.");
       // all qubits deallocated,
       resetQubitState();
-      while (!gateQueue.empty())
-        gateQueue.pop();
+      gateQueue.clear();
+    } else if (compactStateOnDeallocation) {
+      compactState();
     }
   }
 
@@ -576,11 +892,12 @@ public:
 
     // If we are sampling...
     if (execContextName.find("sample") != std::string::npos) {
-      // Sample the state over the specified number of shots
-      if (sampleQubits.empty()) {
-        sampleQubits.resize(nQubitsAllocated);
-        std::iota(sampleQubits.begin(), sampleQubits.end(), 0);
-      }
+      // Sample the state over the specified number of shots, all qubits
+      // that have not been deallocated by default.
+      if (sampleQubits.empty())
+        for (std::size_t i = 0; i < tracker.totalNumQubits(); i++)
+          if (!tracker.isAvailable(i))
+            sampleQubits.push_back(i);
 
       // Flush the queue if there are any gates to apply
       flushGateQueue();
@@ -623,7 +940,41 @@ public:
     // Set the state data if requested.
     if (executionContext->name == "extract-state") {
       flushGateQueue();
-      executionContext->simulationData = getStateData();
+      // The state is reset below once the deferred qubits are deallocated,
+      // its memory can be handed over instead of copied.
+      if (tracker.numAvailable() + deferredDeallocation.size() ==
+          tracker.totalNumQubits())
+        executionContext->simulationDataHandle = releaseStateData();
+      if (!executionContext->simulationDataHandle.second)
+        executionContext->simulationData = getStateData();
+    }
+
+    // Compute the requested amplitudes or probabilities in place. An invalid
+    // query is reported once the deferred qubits have been deallocated.
+    std::exception_ptr queryError;
+    try {
+      if (executionContext->name == "extract-amplitudes") {
+        flushGateQueue();
+        executionContext->amplitudes =
+            getAmplitudes(executionContext->amplitudeBitStrings);
+      } else if (executionContext->name == "extract-probabilities") {
+        flushGateQueue();
+        executionContext->probabilities =
+            getProbabilities(executionContext->probabilityQubits);
+      }
+    } catch (...) {
+      queryError = std::current_exception();
+    }
+
+    // Simulate the recorded circuits of a batched observe task.
+    if (isBatching()) {
+      if (executionContext->name == "observe-gradient")
+        handleObserveGradient();
+      else
+        executionContext->batchExpectationValues =
+            observeBatch(*executionContext->spin.value());
+      batchCircuits.clear();
+      batchQubits.clear();
     }
 
     executionContext = nullptr;
@@ -638,15 +989,31 @@ public:
       cudaq::info("Deallocated all qubits, reseting state vector.");
       // all qubits deallocated,
       resetQubitState();
+    } else if (compactStateOnDeallocation && !deferredDeallocation.empty()) {
+      compactState();
     }
 
     deferredDeallocation.clear();
+
+    if (queryError)
+      std::rethrow_exception(queryError);
   }
 
   /// @brief Set the execution context
   void setExecutionContext(cudaq::ExecutionContext *context) override {
     executionContext = context;
-    executionContext->canHandleObserve = canHandleObserve();
+    if (context->name == "observe-batch" ||
+        context->name == "observe-gradient") {
+      executionContext->canHandleObserve = context->name == "observe-batch"
+                                               ? canHandleObserveBatch()
+                                               : canHandleObserveGradient();
+      batchCircuits.clear();
+      batchCircuits.resize(context->batchSize);
+      batchQubits.clear();
+      batchQubits.resize(context->batchSize);
+    } else {
+      executionContext->canHandleObserve = canHandleObserve();
+    }
     currentCircuitName = context->kernelName;
     cudaq::info("Setting current circuit name to {}", currentCircuitName);
   }
@@ -681,12 +1048,8 @@ public:
     flushAnySamplingTasks();
     QuantumOperation gate;
     cudaq::info(gateToString(gate.name(), controls, angles, targets));
-    enqueueGate(gate.name(), gate.getGate(angles), controls, targets);
-    if (executionContext && executionContext->noiseModel) {
-      std::vector<std::size_t> noiseQubits{controls.begin(), controls.end()};
-      noiseQubits.insert(noiseQubits.end(), targets.begin(), targets.end());
-      applyNoiseChannel(gate.name(), noiseQubits);
-    }
+    // Noise channels are applied after the gate when the queue is flushed.
+    enqueueGate(gate.name(), gate.getGate(angles), controls, targets, angles);
   }
 
 #define CIRCUIT_SIMULATOR_ONE_QUBIT(NAME)                                      \
@@ -785,6 +1148,10 @@ public:
   /// measure, collapse, and return the bit.
   bool mz(const std::size_t qubitIdx,
           const std::string &registerName) override {
+    if (isBatching())
+      throw std::runtime_error(
+          "Batched observe kernels cannot contain measurements.");
+
     // Flush the Gate Queue
     flushGateQueue();
 
@@ -9,6 +9,9 @@
 #pragma once
 
 #include <complex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace nvqir {
@@ -99,6 +102,58 @@ getGateByName(GateName name, const std::vector<Scalar> angles = {}) {
   throw std::runtime_error("Invalid gate provided to getGateByName.");
 }
 
+/// @brief Given the name of a parameterized gate (an element of the GateName
+/// enum) and its angles, return the derivative of the matrix data with
+/// respect to the angle at index `k`.
+template <typename Scalar>
+std::vector<std::complex<Scalar>>
+getGateDerivativeByName(GateName name, std::vector<Scalar> angles,
+                        std::size_t k) {
+  // d/dθ exp(-iθP/2) = exp(-i(θ + π)P/2) / 2, which also holds for the θ
+  // dependence of U3.
+  if (name == GateName::Rx || name == GateName::Ry || name == GateName::Rz ||
+      (name == GateName::U3 && k == 0)) {
+    angles[k] += static_cast<Scalar>(M_PI);
+    auto matrix = getGateByName<Scalar>(name, angles);
+    for (auto &element : matrix)
+      element /= static_cast<Scalar>(2.);
+    return matrix;
+  }
+
+  // The other angles are phases, the derivative multiplies the elements
+  // that depend on the phase by i and zeroes the others.
+  std::vector<bool> dependsOnPhase;
+  if (name == GateName::R1 || name == GateName::U1)
+    dependsOnPhase = {false, false, false, true};
+  // In U2(φ, λ) φ multiplies elements 2 and 3 and λ elements 1 and 3, in
+  // U3(θ, φ, λ) φ multiplies elements 1 and 3 and λ elements 2 and 3.
+  else if ((name == GateName::U2 && k == 0) || (name == GateName::U3 && k == 2))
+    dependsOnPhase = {false, false, true, true};
+  else if ((name == GateName::U2 && k == 1) || (name == GateName::U3 && k == 1))
+    dependsOnPhase = {false, true, false, true};
+  else
+    throw std::runtime_error(
+        "Invalid gate provided to getGateDerivativeByName.");
+
+  auto matrix = getGateByName<Scalar>(name, angles);
+  for (std::size_t i = 0; i < matrix.size(); i++)
+    matrix[i] = dependsOnPhase[i] ? im<Scalar> * matrix[i]
+                                  : std::complex<Scalar>(0.);
+  return matrix;
+}
+
+/// @brief Return the GateName of the parameterized gate with the given name.
+inline GateName getParameterizedGateName(const std::string &name) {
+  static const std::unordered_map<std::string, GateName> names{
+      {"rx", GateName::Rx}, {"ry", GateName::Ry}, {"rz", GateName::Rz},
+      {"r1", GateName::R1}, {"u1", GateName::U1}, {"u2", GateName::U2},
+      {"u3", GateName::U3}};
+  auto iter = names.find(name);
+  if (iter == names.end())
+    throw std::runtime_error("Unknown parameterized gate " + name + ".");
+  return iter->second;
+}
+
 /// @brief The X operation as a type. Can instantiate and request
 /// its matrix data.
 template <typename ScalarType = double>
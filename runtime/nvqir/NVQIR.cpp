@@ -266,6 +266,36 @@ ONE_QUBIT_PARAM_QIS_FUNCTION(ry);
 ONE_QUBIT_PARAM_QIS_FUNCTION(rz);
 ONE_QUBIT_PARAM_QIS_FUNCTION(r1);
 
+void __quantum__qis__u2(double phi, double lambda, Qubit *qubit) {
+  auto targetIdx = qubitToSizeT(qubit);
+  cudaq::ScopedTrace trace("NVQIR::u2", phi, lambda, targetIdx);
+  nvqir::getCircuitSimulatorInternal()->u2(phi, lambda, targetIdx);
+}
+void __quantum__qis__u2__ctl(double phi, double lambda, Array *ctrlQubits,
+                             Qubit *qubit) {
+  auto ctrlIdxs = arrayToVectorSizeT(ctrlQubits);
+  auto targetIdx = qubitToSizeT(qubit);
+  cudaq::ScopedTrace trace("NVQIR::ctrl-u2", phi, lambda, ctrlIdxs,
+                           targetIdx);
+  nvqir::getCircuitSimulatorInternal()->u2(phi, lambda, ctrlIdxs, targetIdx);
+}
+
+void __quantum__qis__u3(double theta, double phi, double lambda,
+                        Qubit *qubit) {
+  auto targetIdx = qubitToSizeT(qubit);
+  cudaq::ScopedTrace trace("NVQIR::u3", theta, phi, lambda, targetIdx);
+  nvqir::getCircuitSimulatorInternal()->u3(theta, phi, lambda, targetIdx);
+}
+void __quantum__qis__u3__ctl(double theta, double phi, double lambda,
+                             Array *ctrlQubits, Qubit *qubit) {
+  auto ctrlIdxs = arrayToVectorSizeT(ctrlQubits);
+  auto targetIdx = qubitToSizeT(qubit);
+  cudaq::ScopedTrace trace("NVQIR::ctrl-u3", theta, phi, lambda, ctrlIdxs,
+                           targetIdx);
+  nvqir::getCircuitSimulatorInternal()->u3(theta, phi, lambda, ctrlIdxs,
+                                           targetIdx);
+}
+
 void __quantum__qis__swap(Qubit *q, Qubit *r) {
   auto qI = qubitToSizeT(q);
   auto rI = qubitToSizeT(r);
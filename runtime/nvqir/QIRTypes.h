@@ -139,6 +139,12 @@ public:
     std::sort(availableIndices.begin(), availableIndices.end());
   }
 
+  /// Return true if the qubit index is available
+  bool isAvailable(std::size_t idx) {
+    return std::binary_search(availableIndices.begin(), availableIndices.end(),
+                              idx);
+  }
+
   /// Get the number of remaining available qubit ids
   std::size_t numAvailable() { return availableIndices.size(); }
 
@@ -460,6 +460,59 @@ public:
     }
   }
 
+  /// @brief Copy only the requested amplitudes from the device.
+  std::vector<std::complex<double>>
+  getAmplitudes(const std::vector<std::string> &bitStrings) override {
+    std::vector<std::complex<double>> amplitudes;
+    amplitudes.reserve(bitStrings.size());
+    for (auto &bitString : bitStrings) {
+      if (bitString.size() != nQubitsAllocated ||
+          bitString.find_first_not_of("01") != std::string::npos)
+        throw std::runtime_error("Invalid basis state " + bitString +
+                                 ", expected one 0 or 1 per qubit (" +
+                                 std::to_string(nQubitsAllocated) +
+                                 " qubits).");
+      // Qubit i is bit i of the amplitude index.
+      std::size_t index = 0;
+      for (std::size_t i = 0; i < bitString.size(); i++)
+        if (bitString[i] == '1')
+          index |= 1ULL << i;
+      DataType amplitude;
+      HANDLE_CUDA_ERROR(
+          cudaMemcpy(&amplitude,
+                     reinterpret_cast<CudaDataType *>(deviceStateVector) +
+                         index,
+                     sizeof(CudaDataType), cudaMemcpyDeviceToHost));
+      amplitudes.emplace_back(amplitude);
+    }
+    return amplitudes;
+  }
+
+  /// @brief Compute the marginal probabilities of the qubits on the device.
+  std::vector<double>
+  getProbabilities(const std::vector<std::size_t> &qubits) override {
+    // The first bit of the ordering is the least significant bit of the
+    // outcome index, the first qubit must be the most significant one.
+    std::vector<int32_t> bitOrdering;
+    for (auto q : qubits) {
+      if (q >= nQubitsAllocated)
+        throw std::runtime_error("Invalid qubit " + std::to_string(q) + " (" +
+                                 std::to_string(nQubitsAllocated) +
+                                 " qubits).");
+      bitOrdering.insert(bitOrdering.begin(), q);
+    }
+    if (qubits.empty())
+      for (std::size_t q = 0; q < nQubitsAllocated; q++)
+        bitOrdering.insert(bitOrdering.begin(), q);
+
+    std::vector<double> probabilities(1ULL << bitOrdering.size());
+    HANDLE_ERROR(custatevecAbs2SumArray(
+        handle, deviceStateVector, cuStateVecCudaDataType, nQubitsAllocated,
+        probabilities.data(), bitOrdering.data(), bitOrdering.size(), nullptr,
+        nullptr, 0));
+    return probabilities;
+  }
+
   std::string name() const override;
   NVQIR_SIMULATOR_CLONE_IMPL(CuStateVecCircuitSimulator<ScalarType>)
 };
@@ -8,25 +8,196 @@
 
 #include "CircuitSimulator.h"
 #include "Gates.h"
+#include "StateVectorKernels.h"
 #include "qpp.h"
+#include <bit>
 #include <iostream>
+#include <random>
 
 namespace nvqir {
 
+/// @brief The floating point precision of the amplitudes of the given
+/// Eigen state type.
+template <typename StateType>
+using QppScalarType =
+    typename Eigen::NumTraits<typename StateType::Scalar>::Real;
+
 /// @brief The QppCircuitSimulator implements the CircuitSimulator
 /// base class to provide a simulator delegating to the Q++ library from
-/// https://github.com/softwareqinc/qpp.
+/// https://github.com/softwareqinc/qpp. The state is either a state vector
+/// (qpp::ket, or Eigen::VectorXcf for single precision) or a density
+/// matrix (qpp::cmat).
 template <typename StateType>
-class QppCircuitSimulator : public nvqir::CircuitSimulatorBase<double> {
+class QppCircuitSimulator
+    : public nvqir::CircuitSimulatorBase<QppScalarType<StateType>> {
 protected:
-  /// The QPP state representation (qpp::ket or qpp::cmat)
+  using ScalarType = QppScalarType<StateType>;
+  using Base = nvqir::CircuitSimulatorBase<ScalarType>;
+  using typename Base::GateApplicationTask;
+  using Base::batchCircuits;
+  using Base::batchQubits;
+  using Base::calculateStateDim;
+  using Base::compactStateOnDeallocation;
+  using Base::executionContext;
+  using Base::gateQueue;
+  using Base::haveSameStructure;
+  using Base::isBatching;
+  using Base::maxFusedQubits;
+  using Base::nQubitsAllocated;
+  using Base::stateDimension;
+  using Base::tracker;
+
+  /// @brief True if the state is a state vector, false if it is a density
+  /// matrix.
+  static constexpr bool isStateVector = StateType::IsVectorAtCompileTime;
+
+  /// @brief The state vector type with the same precision as StateType.
+  using StateVectorType =
+      Eigen::Matrix<std::complex<ScalarType>, Eigen::Dynamic, 1>;
+
+  /// The QPP state representation (qpp::ket, Eigen::VectorXcf or qpp::cmat)
   StateType state;
 
+  /// @brief The number of low order bits of the amplitude index that the
+  /// qubits most targeted by the queued gates are remapped onto while the
+  /// gate queue is flushed, 0 disables the remapping.
+  std::size_t localityQubits = 0;
+
+  /// @brief The bit of the amplitude index of each qubit while the gate
+  /// queue is flushed with a remapped layout. Empty for the big endian layout
+  /// used everywhere else.
+  std::vector<std::size_t> qubitBits;
+
+  /// @brief The bit swaps applied to the state for the remapped layout, in
+  /// order, to be undone once the gate queue is flushed.
+  std::vector<std::pair<std::size_t, std::size_t>> layoutSwaps;
+
+  /// @brief True while the gate queue is flushed without a noise model, the
+  /// gates that only target the low order localityQubits bits are then
+  /// collected in tiledGates rather than applied one at a time.
+  bool tilingGates = false;
+
+  /// @brief The consecutive gates of the current tiled pass.
+  std::vector<TiledGate<ScalarType>> tiledGates;
+
   /// Convert from little endian to big endian.
   std::size_t bigEndian(const int n_qubits, const int bit) {
     return n_qubits - bit - 1;
   }
 
+  /// @brief The X and Z masks over the amplitude index, and the coefficient,
+  /// of a term of a spin_op.
+  struct TermMasks {
+    std::size_t xMask = 0;
+    std::size_t zMask = 0;
+    std::complex<double> coefficient;
+  };
+
+  /// @brief Return the masks of every term of the spin_op on a state vector
+  /// of nQubits qubits, read from the packed words of the term views.
+  std::vector<TermMasks> getTermMasks(const cudaq::spin_op &op,
+                                      std::size_t nQubits) {
+    std::vector<TermMasks> masks;
+    masks.reserve(op.n_terms());
+    op.for_each_term_view([&](const cudaq::spin_op::term_view &term) {
+      auto toMask = [&](const std::uint64_t *words) {
+        std::size_t mask = 0;
+        for (std::size_t w = 0; w < term.n_words(); w++)
+          for (auto bits = words[w]; bits != 0; bits &= bits - 1)
+            mask |= 1ULL << bigEndian(nQubits, 64 * w + std::countr_zero(bits));
+        return mask;
+      };
+      masks.push_back({toMask(term.x_words()), toMask(term.z_words()),
+                       term.get_coefficient()});
+    });
+    return masks;
+  }
+
+  /// @brief Return the bit of the amplitude index of the given qubit in the
+  /// current layout of the state vector.
+  std::size_t qubitBit(std::size_t nQubits, std::size_t qubit) {
+    return qubitBits.empty() ? bigEndian(nQubits, qubit) : qubitBits[qubit];
+  }
+
+  /// @brief Swap the qubits that the queued gates act on most often onto
+  /// the low order bits of the amplitude index, in place of the least used
+  /// ones, so that the amplitudes the gates combine are close together in
+  /// memory. A swap costs about one gate pass, it is only done if enough
+  /// more gates act on the incoming qubit than on the outgoing one.
+  void remapQubitLayout() {
+    const auto nQubits = stateNumQubits();
+    if (localityQubits == 0 || nQubits <= localityQubits)
+      return;
+
+    std::vector<std::size_t> gateCounts(nQubits, 0);
+    for (auto &task : gateQueue) {
+      for (auto c : task.controls)
+        gateCounts[c]++;
+      for (auto t : task.targets)
+        gateCounts[t]++;
+    }
+
+    std::vector<std::size_t> highQubits, lowQubits;
+    qubitBits.resize(nQubits);
+    for (std::size_t q = 0; q < nQubits; q++) {
+      qubitBits[q] = bigEndian(nQubits, q);
+      (qubitBits[q] < localityQubits ? lowQubits : highQubits).push_back(q);
+    }
+    auto moreGates = [&](std::size_t a, std::size_t b) {
+      return gateCounts[a] > gateCounts[b];
+    };
+    auto fewerGates = [&](std::size_t a, std::size_t b) {
+      return gateCounts[a] < gateCounts[b];
+    };
+    std::stable_sort(highQubits.begin(), highQubits.end(), moreGates);
+    std::stable_sort(lowQubits.begin(), lowQubits.end(), fewerGates);
+
+    for (std::size_t i = 0; i < std::min(highQubits.size(), lowQubits.size());
+         i++) {
+      const auto high = highQubits[i], low = lowQubits[i];
+      if (gateCounts[high] < gateCounts[low] + LocalityRemapMinGates)
+        break;
+      swapStateVectorBits(state.data(), nQubits, qubitBits[high],
+                          qubitBits[low]);
+      layoutSwaps.emplace_back(qubitBits[high], qubitBits[low]);
+      std::swap(qubitBits[high], qubitBits[low]);
+    }
+
+    if (layoutSwaps.empty())
+      qubitBits.clear();
+    else
+      cudaq::info("Remapped {} qubits onto the low order bits of the state.",
+                  layoutSwaps.size());
+  }
+
+  /// @brief Apply the collected gates in a single tiled pass over the state
+  /// vector, or on their own if there is only one.
+  void applyTiledGateQueue() {
+    const auto nQubits = stateNumQubits();
+    if (tiledGates.size() == 1) {
+      auto &gate = tiledGates.front();
+      auto controls = gate.controls;
+      for (std::size_t b = localityQubits; b < nQubits; b++)
+        if (gate.highControlMask & (1ULL << b))
+          controls.push_back(b);
+      applyStateVectorGate(state.data(), nQubits, gate.matrix.data(),
+                           controls, gate.targets);
+    } else if (!tiledGates.empty()) {
+      applyTiledGates(state.data(), nQubits, localityQubits, tiledGates);
+    }
+    tiledGates.clear();
+  }
+
+  /// @brief Undo the swaps of remapQubitLayout(), back to the big endian
+  /// layout.
+  void restoreQubitLayout() {
+    const auto nQubits = stateNumQubits();
+    for (auto iter = layoutSwaps.rbegin(); iter != layoutSwaps.rend(); ++iter)
+      swapStateVectorBits(state.data(), nQubits, iter->first, iter->second);
+    layoutSwaps.clear();
+    qubitBits.clear();
+  }
+
   /// @brief Compute the expectation value <Z...Z> over the given qubit indices.
   /// @param qubit_indices
   /// @return expectation
@@ -51,7 +222,7 @@ protected:
     }
 
     double result = 0.0;
-    if constexpr (std::is_same_v<StateType, qpp::ket>) {
+    if constexpr (isStateVector) {
 #pragma omp parallel for reduction(+ : result)
       for (std::size_t i = 0; i < stateDimension; ++i) {
         result += (hasEvenParity(i, casted_qubit_indices) ? 1.0 : -1.0) *
@@ -71,16 +242,27 @@ protected:
     return result;
   }
 
-  qpp::cmat toQppMatrix(const std::vector<std::complex<double>> &data,
-                        std::size_t nTargets) {
+  Eigen::Matrix<std::complex<ScalarType>, Eigen::Dynamic, Eigen::Dynamic>
+  toQppMatrix(const std::vector<std::complex<ScalarType>> &data,
+              std::size_t nTargets) {
     auto nRows = (1UL << nTargets);
     assert(data.size() == nRows * nRows &&
            "Invalid number of gate matrix elements passed to toQppMatrix");
 
     // we represent row major, they represent column major
-    return Eigen::Map<Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
+    return Eigen::Map<Eigen::Matrix<std::complex<ScalarType>, Eigen::Dynamic,
                                     Eigen::Dynamic, Eigen::RowMajor>>(
-        const_cast<std::complex<double> *>(data.data()), nRows, nRows);
+        const_cast<std::complex<ScalarType> *>(data.data()), nRows, nRows);
+  }
+
+  /// @brief Grow the state vector by `count` qubits in the zero state. This
+  /// is the Kronecker product of the existing state with |0...0>, i.e. the
+  /// new qubits are the low order bits of the amplitude index.
+  void growStateVector(std::size_t count) {
+    StateVectorType grown = StateVectorType::Zero(stateDimension);
+    for (Eigen::Index i = 0; i < state.size(); i++)
+      grown(i << count) = state(i);
+    state = std::move(grown);
   }
 
   /// @brief Grow the state vector by one qubit.
@@ -88,15 +270,25 @@ protected:
     // Update the state vector
     if (state.size() == 0) {
       // If this is the first time, allocate the state
-      state = qpp::ket::Zero(stateDimension);
+      state = StateVectorType::Zero(stateDimension);
       state(0) = 1.0;
     } else {
-      // If we are resizing an existing, allocate
-      // a zero state on a single qubit, and Kron-prod
-      // that with the existing state.
-      qpp::ket zero_state = qpp::ket::Zero(2);
-      zero_state(0) = 1.0;
-      state = qpp::kron(state, zero_state);
+      growStateVector(1);
+    }
+  }
+
+  /// @brief Trace out the qubit with the highest index, the least
+  /// significant bit of the amplitude index. A state vector cannot hold the
+  /// mixed state left when the qubit is entangled with the others, so keep
+  /// the branch of a measurement of the qubit, which averages to it. A qubit
+  /// in |0> leaves the even amplitudes unchanged.
+  void removeQubitFromState() override {
+    if constexpr (isStateVector) {
+      const Eigen::Index offset = measureQubit(stateNumQubits() - 1) ? 1 : 0;
+      const Eigen::Index half = state.size() / 2;
+      for (Eigen::Index i = 0; i < half; i++)
+        state(i) = state(2 * i + offset);
+      state.conservativeResize(half);
     }
   }
 
@@ -106,18 +298,160 @@ protected:
     state = tmp;
   }
 
+  /// @brief Simulate the given recorded circuits of a batched observe task,
+  /// which have the same structure, and return the expectation value of the
+  /// spin_op for each.
+  std::vector<double> simulateBatch(const std::vector<std::size_t> &batch,
+                                    const cudaq::spin_op &op) {
+    const std::size_t batchSize = batch.size();
+    const std::size_t nQubits = batchQubits[batch.front()].size();
+    const auto nSpinQubits = op.n_qubits();
+    if (nSpinQubits > nQubits)
+      throw std::runtime_error("The spin_op acts on more qubits than are "
+                               "allocated by the batched observe kernel.");
+
+    // Amplitude i of copy b is at i * batchSize + b, all start in |0>.
+    std::vector<std::complex<ScalarType>> states(batchSize << nQubits, 0.);
+    std::fill_n(states.begin(), batchSize, 1.);
+
+    std::vector<std::complex<ScalarType>> matrices;
+    std::vector<std::size_t> controls, targets;
+    for (std::size_t g = 0; g < batchCircuits[batch.front()].size(); g++) {
+      const auto &gate = batchCircuits[batch.front()][g];
+      const std::size_t nElements = gate.matrix.size();
+      matrices.resize(nElements * batchSize);
+      for (std::size_t i = 0; i < batchSize; i++) {
+        const auto &matrix = batchCircuits[batch[i]][g].matrix;
+        for (std::size_t e = 0; e < nElements; e++)
+          matrices[e * batchSize + i] = matrix[e];
+      }
+
+      controls.clear();
+      targets.clear();
+      for (auto c : gate.controls)
+        controls.push_back(bigEndian(nQubits, c));
+      for (auto t : gate.targets)
+        targets.push_back(bigEndian(nQubits, t));
+      applyBatchedGate(states.data(), nQubits, batchSize, matrices.data(),
+                       controls, targets);
+    }
+
+    std::vector<double> expectationValues(batchSize, 0.0);
+    for (const auto &[xMask, zMask, coefficient] : getTermMasks(op, nQubits)) {
+      if (xMask == 0 && zMask == 0) {
+        for (auto &value : expectationValues)
+          value += coefficient.real();
+        continue;
+      }
+      const auto termExpectations = getBatchedPauliExpectations(
+          states.data(), nQubits, batchSize, xMask, zMask);
+      for (std::size_t i = 0; i < batchSize; i++)
+        expectationValues[i] += coefficient.real() * termExpectations[i];
+    }
+    return expectationValues;
+  }
+
+  /// @brief Return the number of qubits spanned by the current state vector.
+  std::size_t stateNumQubits() const {
+    return static_cast<std::size_t>(std::log2(state.rows()));
+  }
+
   void applyGate(const GateApplicationTask &task) override {
-    auto matrix = toQppMatrix(task.matrix, task.targets.size());
-    state = qpp::applyCTRL(state, matrix, task.controls, task.targets);
+    if constexpr (isStateVector) {
+      // Apply the gate in place rather than through qpp::applyCTRL, which
+      // allocates and returns a new 2^n ket for every gate.
+      const auto nQubits = stateNumQubits();
+      std::vector<std::size_t> controls, targets;
+      for (auto c : task.controls)
+        controls.push_back(qubitBit(nQubits, c));
+      for (auto t : task.targets)
+        targets.push_back(qubitBit(nQubits, t));
+
+      // Gates that only target bits within a tile are applied together, tile
+      // by tile, until a gate targets a bit above the tile.
+      const bool tileLocal =
+          std::all_of(targets.begin(), targets.end(),
+                      [&](std::size_t t) { return t < localityQubits; });
+      if (tilingGates && nQubits > localityQubits && tileLocal) {
+        TiledGate<ScalarType> gate{task.matrix, {}, targets};
+        for (auto c : controls)
+          if (c < localityQubits)
+            gate.controls.push_back(c);
+          else
+            gate.highControlMask |= 1ULL << c;
+        tiledGates.push_back(std::move(gate));
+        return;
+      }
+      applyTiledGateQueue();
+      applyStateVectorGate(state.data(), nQubits, task.matrix.data(), controls,
+                           targets);
+    } else {
+      auto matrix = toQppMatrix(task.matrix, task.targets.size());
+      state = qpp::applyCTRL(state, matrix, task.controls, task.targets);
+    }
+  }
+
+  /// @brief Flush the gate queue. Without a noise model, whose channels are
+  /// applied in the big endian layout between the gates, the state vector
+  /// is first remapped for locality, see remapQubitLayout(), and runs of
+  /// gates on the low order bits are applied in tiled passes.
+  void flushGateQueueImpl() override {
+    if constexpr (isStateVector) {
+      if (!(executionContext && executionContext->noiseModel)) {
+        remapQubitLayout();
+        tilingGates = localityQubits > 0;
+      }
+    }
+    Base::flushGateQueueImpl();
+    if constexpr (isStateVector) {
+      applyTiledGateQueue();
+      tilingGates = false;
+      restoreQubitLayout();
+    }
   }
 
 public:
-  QppCircuitSimulator() = default;
+  using Base::flushGateQueue;
+
+  QppCircuitSimulator() {
+    compactStateOnDeallocation = true;
+
+    // Fuse gates on the state vector path, where each gate is a full
+    // pass over the state. CUDAQ_FUSION_MAX_QUBITS overrides the
+    // maximum fused gate size, 0 or 1 disables fusion.
+    if constexpr (isStateVector) {
+      maxFusedQubits = DefaultMaxFusedQubits;
+      if (auto *envVal = std::getenv("CUDAQ_FUSION_MAX_QUBITS")) {
+        try {
+          maxFusedQubits = std::stoul(envVal);
+        } catch (...) {
+          throw std::runtime_error("Invalid CUDAQ_FUSION_MAX_QUBITS "
+                                   "environment variable, must be integer.");
+        }
+      }
+
+      // CUDAQ_LOCALITY_QUBITS overrides the number of low order bits the
+      // most used qubits are remapped onto, 0 disables the remapping.
+      localityQubits = DefaultLocalityQubits;
+      if (auto *envVal = std::getenv("CUDAQ_LOCALITY_QUBITS")) {
+        try {
+          localityQubits = std::stoul(envVal);
+        } catch (...) {
+          throw std::runtime_error("Invalid CUDAQ_LOCALITY_QUBITS "
+                                   "environment variable, must be integer.");
+        }
+      }
+    }
+  }
   virtual ~QppCircuitSimulator() = default;
 
   /// @brief Override the default sized allocation of qubits
   /// here to be a bit more efficient than the default implementation
   std::vector<std::size_t> allocateQubits(const std::size_t count) override {
+    // Qubits of a batched observe task are only recorded.
+    if (isBatching())
+      return Base::allocateQubits(count);
+
     std::vector<std::size_t> qubits;
     for (std::size_t i = 0; i < count; i++)
       qubits.emplace_back(tracker.getNextIndex());
@@ -126,20 +460,26 @@ public:
       // If this is the first time, allocate the state
       nQubitsAllocated += count;
       stateDimension = calculateStateDim(nQubitsAllocated);
-      state = qpp::ket::Zero(stateDimension);
+      state = StateVectorType::Zero(stateDimension);
       state(0) = 1.0;
       return qubits;
     }
 
-    nQubitsAllocated += count;
+    // Deallocated qubits still in the state are reused, only grow the state
+    // for the new highest indices.
+    std::size_t newNQubits = nQubitsAllocated;
+    for (auto q : qubits)
+      newNQubits = std::max(newNQubits, q + 1);
+    const auto nNewQubits = newNQubits - nQubitsAllocated;
+    if (nNewQubits == 0)
+      return qubits;
+
+    nQubitsAllocated = newNQubits;
     stateDimension = calculateStateDim(nQubitsAllocated);
 
-    // If we are resizing an existing, allocate
-    // a zero state on a n qubit, and Kron-prod
-    // that with the existing state.
-    qpp::ket zero_state = qpp::ket::Zero((1UL << count));
-    zero_state(0) = 1.0;
-    state = qpp::kron(state, zero_state);
+    // If we are resizing an existing, Kron-prod
+    // the existing state with a zero state on n qubits.
+    growStateVector(nNewQubits);
 
     return qubits;
   }
@@ -147,62 +487,106 @@ public:
   /// @brief Measure the qubit and return the result. Collapse the
   /// state vector.
   bool measureQubit(const std::size_t qubitIdx) override {
-    // If here, then we care about the result bit, so compute it.
-    const auto measurement_tuple =
-        qpp::measure(state, qpp::cmat::Identity(2, 2), {qubitIdx},
-                     /*qudit dimension=*/2, /*destructive measmt=*/false);
-    const auto measurement_result = std::get<qpp::RES>(measurement_tuple);
-    const auto &post_meas_states = std::get<qpp::ST>(measurement_tuple);
-    const auto &collapsed_state = post_meas_states[measurement_result];
-    if constexpr (std::is_same_v<StateType, qpp::ket>) {
-      state = Eigen::Map<const StateType>(collapsed_state.data(),
-                                          collapsed_state.size());
+    if constexpr (isStateVector) {
+      const auto nQubits = stateNumQubits();
+      const auto bit = bigEndian(nQubits, qubitIdx);
+      const double probabilityOfOne =
+          getProbabilityOfOne(state.data(), nQubits, bit);
+      std::uniform_real_distribution<double> distribution(0.0, 1.0);
+      const bool result = distribution(qpp::RandomDevices::get_instance()
+                                           .get_prng()) < probabilityOfOne;
+      collapseQubit(state.data(), nQubits, bit, result,
+                    result ? probabilityOfOne : 1.0 - probabilityOfOne);
+      cudaq::info("Measured qubit {} -> {}", qubitIdx, result);
+      return result;
     } else {
+      // If here, then we care about the result bit, so compute it.
+      const auto measurement_tuple =
+          qpp::measure(state, qpp::cmat::Identity(2, 2), {qubitIdx},
+                       /*qudit dimension=*/2, /*destructive measmt=*/false);
+      const auto measurement_result = std::get<qpp::RES>(measurement_tuple);
+      const auto &post_meas_states = std::get<qpp::ST>(measurement_tuple);
+      const auto &collapsed_state = post_meas_states[measurement_result];
       state = Eigen::Map<const StateType>(collapsed_state.data(),
                                           collapsed_state.rows(),
                                           collapsed_state.cols());
+      cudaq::info("Measured qubit {} -> {}", qubitIdx, measurement_result);
+      return measurement_result == 1 ? true : false;
     }
-    cudaq::info("Measured qubit {} -> {}", qubitIdx, measurement_result);
-    return measurement_result == 1 ? true : false;
   }
 
   /// @brief Reset the qubit
   /// @param qubitIdx
   void resetQubit(const std::size_t qubitIdx) override {
     flushGateQueue();
-    state = qpp::reset(state, {qubitIdx});
+    if constexpr (isStateVector) {
+      // Measure the qubit, and flip it back to zero if needed.
+      if (measureQubit(qubitIdx)) {
+        const std::complex<ScalarType> pauliX[] = {0.0, 1.0, 1.0, 0.0};
+        const auto nQubits = stateNumQubits();
+        applyOneQubitGate(state.data(), nQubits, pauliX, {},
+                          bigEndian(nQubits, qubitIdx));
+      }
+    } else {
+      state = qpp::reset(state, {qubitIdx});
+    }
   }
 
-  /// @brief Sample the multi-qubit state.
+  /// @brief Sample the multi-qubit state. The <Z...Z> expectation value of
+  /// the sampled qubits is always exact, not estimated from the shots.
   cudaq::ExecutionResult sample(const std::vector<std::size_t> &measuredBits,
                                 const int shots) override {
-    double expectationValue = calculateExpectationValue(measuredBits);
     if (shots < 1) {
+      double expectationValue = calculateExpectationValue(measuredBits);
       cudaq::info("Computed expectation value = {}", expectationValue);
       return cudaq::ExecutionResult{{}, expectationValue};
     }
 
-    auto sampleResult = qpp::sample(shots, state, measuredBits, 2);
-    // Convert to what we expect
-    std::stringstream bitstring;
-    cudaq::ExecutionResult counts(expectationValue);
+    if constexpr (isStateVector) {
+      // Build the probability table of the measured qubits in a single sweep
+      // over the state, then draw all shots from it.
+      const auto nQubits = stateNumQubits();
+      std::vector<std::size_t> bits;
+      for (auto q : measuredBits)
+        bits.push_back(bigEndian(nQubits, q));
+      const auto probabilities =
+          getMarginalProbabilities(state.data(), nQubits, bits);
+      const auto outcomeCounts = sampleOutcomeCounts(
+          probabilities, shots, qpp::RandomDevices::get_instance().get_prng());
 
-    for (auto [result, count] : sampleResult) {
-      // Push back each term in the vector of bits to the bitstring.
-      for (const auto &bit : result) {
-        bitstring << bit;
-      }
+      // The exact expectation value, from the same marginal table.
+      double expectationValue = 0.0;
+      for (std::size_t o = 0; o < probabilities.size(); o++)
+        expectationValue +=
+            (std::popcount(o) % 2 ? -1.0 : 1.0) * probabilities[o];
+      cudaq::ExecutionResult counts(expectationValue);
 
-      // Add to the sample result
-      // in mid-circ sampling mode this will append 1 bitstring
-      counts.appendResult(bitstring.str(), count);
+      const std::size_t nBits = bits.size();
+      std::string bitstring(nBits, '0');
+      for (std::size_t o = 0; o < outcomeCounts.size(); o++) {
+        if (outcomeCounts[o] == 0)
+          continue;
+        for (std::size_t j = 0; j < nBits; j++)
+          bitstring[j] = (o >> (nBits - 1 - j)) & 1 ? '1' : '0';
+        // Add to the sample result
+        // in mid-circ sampling mode this will append 1 bitstring
+        counts.appendResult(bitstring, outcomeCounts[o]);
+      }
+      return counts;
+    } else {
+      auto sampleResult = qpp::sample(shots, state, measuredBits, 2);
+      cudaq::ExecutionResult counts(calculateExpectationValue(measuredBits));
 
-      // Reset the state.
-      bitstring.str("");
-      bitstring.clear();
+      std::string bitstring(measuredBits.size(), '0');
+      for (auto &[result, count] : sampleResult) {
+        for (std::size_t j = 0; j < result.size(); j++)
+          bitstring[j] = result[j] ? '1' : '0';
+        // Add to the sample result
+        // in mid-circ sampling mode this will append 1 bitstring
+        counts.appendResult(bitstring, count);
+      }
+      return counts;
     }
-
-    return counts;
   }
 
   cudaq::State getStateData() override {
@@ -212,12 +596,257 @@ public:
                         {state.data(), state.data() + state.size()}};
   }
 
+  /// @brief Move the state vector into the returned handle. Single precision
+  /// states are converted by getStateData() instead.
+  cudaq::StateHandle releaseStateData() override {
+    if constexpr (!std::is_same_v<ScalarType, double>) {
+      return {};
+    } else {
+      auto owner = std::make_shared<StateType>(std::move(state));
+      state = StateType();
+      return {{stateDimension},
+              std::shared_ptr<std::complex<double>>(owner, owner->data())};
+    }
+  }
+
+  /// @brief Read the requested amplitudes directly from the state vector.
+  std::vector<std::complex<double>>
+  getAmplitudes(const std::vector<std::string> &bitStrings) override {
+    if constexpr (!isStateVector) {
+      return Base::getAmplitudes(bitStrings);
+    } else {
+      const auto nQubits = stateNumQubits();
+      std::vector<std::complex<double>> amplitudes;
+      amplitudes.reserve(bitStrings.size());
+      for (auto &bitString : bitStrings) {
+        if (bitString.size() != nQubits ||
+            bitString.find_first_not_of("01") != std::string::npos)
+          throw std::runtime_error("Invalid basis state " + bitString +
+                                   ", expected one 0 or 1 per qubit (" +
+                                   std::to_string(nQubits) + " qubits).");
+        // Qubit 0 is the most significant bit of the amplitude index.
+        std::size_t index = 0;
+        for (auto bit : bitString)
+          index = (index << 1) | (bit == '1');
+        amplitudes.emplace_back(state(index));
+      }
+      return amplitudes;
+    }
+  }
+
+  /// @brief Compute the marginal probabilities of the qubits in a single
+  /// sweep over the state vector, or over the diagonal of the density matrix.
+  std::vector<double>
+  getProbabilities(const std::vector<std::size_t> &qubits) override {
+    const auto nQubits = stateNumQubits();
+    std::vector<std::size_t> bits;
+    for (auto q : qubits) {
+      if (q >= nQubits)
+        throw std::runtime_error("Invalid qubit " + std::to_string(q) + " (" +
+                                 std::to_string(nQubits) + " qubits).");
+      bits.push_back(bigEndian(nQubits, q));
+    }
+    if (qubits.empty())
+      for (std::size_t q = 0; q < nQubits; q++)
+        bits.push_back(bigEndian(nQubits, q));
+
+    if constexpr (isStateVector) {
+      return getMarginalProbabilities(state.data(), nQubits, bits);
+    } else {
+      const std::size_t nBits = bits.size();
+      std::vector<double> probabilities(1ULL << nBits, 0.0);
+      for (Eigen::Index i = 0; i < state.rows(); i++) {
+        std::size_t outcome = 0;
+        for (std::size_t j = 0; j < nBits; j++)
+          if ((i >> bits[j]) & 1)
+            outcome |= 1ULL << (nBits - 1 - j);
+        probabilities[outcome] += state(i, i).real();
+      }
+      return probabilities;
+    }
+  }
+
+  /// @brief Exact (no shots) expectation values of spin_ops are computed
+  /// directly from the state vector by observe(). With shots, NVQIR still
+  /// applies the basis change gates and samples each term.
+  bool canHandleObserve() override {
+    if constexpr (isStateVector)
+      return executionContext &&
+             static_cast<int>(executionContext->shots) < 1;
+    return false;
+  }
+
+  /// @brief Compute <psi|H|psi> as the sum of the coefficient times
+  /// <psi|P|psi> for every Pauli term P of H, each from a single sweep over
+  /// the state vector using the X and Z masks of the term.
+  cudaq::ExecutionResult observe(const cudaq::spin_op &op) override {
+    if constexpr (!isStateVector) {
+      return Base::observe(op);
+    } else {
+      flushGateQueue();
+      const auto nQubits = stateNumQubits();
+      const auto nSpinQubits = op.n_qubits();
+      if (nSpinQubits > nQubits)
+        throw std::runtime_error("The spin_op acts on more qubits than are "
+                                 "allocated on the qpp backend.");
+
+      double expectationValue = 0.0;
+      for (const auto &[xMask, zMask, coefficient] :
+           getTermMasks(op, nQubits)) {
+        const double termExpectation =
+            xMask == 0 && zMask == 0
+                ? 1.0
+                : getPauliExpectation(state.data(), nQubits, xMask, zMask);
+        expectationValue += coefficient.real() * termExpectation;
+      }
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult({}, expectationValue);
+    }
+  }
+
+  /// @brief Batched observe tasks are simulated on interleaved copies of
+  /// the state vector.
+  bool canHandleObserveBatch() override { return isStateVector; }
+
+  /// @brief Simulate the recorded circuits of a batched observe task. The
+  /// circuits with the same qubits and the same controls and targets for
+  /// each gate (typically all of them, only the angles differ) are simulated
+  /// together, on interleaved state vectors, applying each gate to all
+  /// copies in one sweep.
+  std::vector<double> observeBatch(const cudaq::spin_op &op) override {
+    if constexpr (!isStateVector) {
+      return Base::observeBatch(op);
+    } else {
+      std::vector<double> expectationValues(batchCircuits.size());
+      std::vector<bool> simulated(batchCircuits.size(), false);
+      for (std::size_t first = 0; first < batchCircuits.size(); first++) {
+        if (simulated[first])
+          continue;
+        std::vector<std::size_t> batch{first};
+        for (std::size_t other = first + 1; other < batchCircuits.size();
+             other++)
+          if (!simulated[other] && haveSameStructure(first, other)) {
+            batch.push_back(other);
+            simulated[other] = true;
+          }
+
+        auto values = simulateBatch(batch, op);
+        for (std::size_t i = 0; i < batch.size(); i++)
+          expectationValues[batch[i]] = values[i];
+      }
+      return expectationValues;
+    }
+  }
+
+  /// @brief Observe-gradient tasks are differentiated with the adjoint
+  /// method on the state vector.
+  bool canHandleObserveGradient() override { return isStateVector; }
+
+  /// @brief Differentiate the first recorded circuit of an observe-gradient
+  /// task with the adjoint method. After simulating |psi>, the gates are
+  /// undone from the last one on both |psi> and |lambda> = H|psi>, and
+  /// the derivative with respect to a parameter of gate G is
+  /// 2 Re <lambda|dG|psi>, with |psi> and |lambda> taken right before and
+  /// right after G. All derivatives cost about three circuit simulations.
+  std::pair<double, std::vector<double>>
+  observeGradient(const cudaq::spin_op &op) override {
+    if constexpr (!isStateVector) {
+      return Base::observeGradient(op);
+    } else {
+      const auto &circuit = batchCircuits.front();
+      const std::size_t nQubits = batchQubits.front().size();
+      const auto nSpinQubits = op.n_qubits();
+      if (nSpinQubits > nQubits)
+        throw std::runtime_error("The spin_op acts on more qubits than are "
+                                 "allocated by the observed kernel.");
+
+      auto toBits = [&](const std::vector<std::size_t> &qubits) {
+        std::vector<std::size_t> bits;
+        for (auto q : qubits)
+          bits.push_back(bigEndian(nQubits, q));
+        return bits;
+      };
+      auto adjoint = [](const GateApplicationTask &gate) {
+        const std::size_t dim = std::sqrt(gate.matrix.size());
+        std::vector<std::complex<ScalarType>> matrix(gate.matrix.size());
+        for (std::size_t r = 0; r < dim; r++)
+          for (std::size_t c = 0; c < dim; c++)
+            matrix[c * dim + r] = std::conj(gate.matrix[r * dim + c]);
+        return matrix;
+      };
+
+      const std::size_t dim = 1ULL << nQubits;
+      std::vector<std::complex<ScalarType>> psi(dim, 0.), lambda(dim, 0.),
+          mu(dim);
+      psi[0] = 1.;
+      std::size_t nParameters = 0;
+      for (auto &gate : circuit) {
+        applyStateVectorGate(psi.data(), nQubits, gate.matrix.data(),
+                             toBits(gate.controls), toBits(gate.targets));
+        nParameters += gate.parameters.size();
+      }
+
+      for (const auto &[xMask, zMask, coefficient] :
+           getTermMasks(op, nQubits))
+        addPauliProduct(lambda.data(), psi.data(), nQubits, xMask, zMask,
+                        coefficient);
+
+      auto overlap = [&](const std::vector<std::complex<ScalarType>> &left,
+                         const std::vector<std::complex<ScalarType>> &right) {
+        std::complex<double> sum = 0.;
+        for (std::size_t i = 0; i < dim; i++)
+          sum += std::conj(left[i]) * right[i];
+        return sum;
+      };
+      const double expectationValue = overlap(psi, lambda).real();
+
+      std::vector<double> gradients(nParameters);
+      for (std::size_t g = circuit.size(); g-- > 0;) {
+        const auto &gate = circuit[g];
+        const auto controls = toBits(gate.controls);
+        const auto targets = toBits(gate.targets);
+        const auto inverse = adjoint(gate);
+        applyStateVectorGate(psi.data(), nQubits, inverse.data(), controls,
+                             targets);
+
+        nParameters -= gate.parameters.size();
+        if (!gate.parameters.empty()) {
+          std::size_t controlMask = 0;
+          for (auto c : controls)
+            controlMask |= 1ULL << c;
+          const auto name = nvqir::getParameterizedGateName(gate.operationName);
+          for (std::size_t k = 0; k < gate.parameters.size(); k++) {
+            // The controlled derivative is zero where a control is not set.
+            const auto derivative = nvqir::getGateDerivativeByName<ScalarType>(
+                name, gate.parameters, k);
+            mu = psi;
+            applyStateVectorGate(mu.data(), nQubits, derivative.data(),
+                                 controls, targets);
+            if (controlMask)
+              for (std::size_t i = 0; i < dim; i++)
+                if ((i & controlMask) != controlMask)
+                  mu[i] = 0.;
+            gradients[nParameters + k] = 2. * overlap(lambda, mu).real();
+          }
+        }
+
+        applyStateVectorGate(lambda.data(), nQubits, inverse.data(), controls,
+                             targets);
+      }
+      return {expectationValue, gradients};
+    }
+  }
+
   /// @brief Primarily used for testing.
   auto getStateVector() {
     flushGateQueue();
     return state;
   }
-  std::string name() const override { return "qpp"; }
+  std::string name() const override {
+    if constexpr (std::is_same_v<ScalarType, float>)
+      return "qpp-f32";
+    return "qpp";
+  }
   NVQIR_SIMULATOR_CLONE_IMPL(QppCircuitSimulator<StateType>)
 };
 
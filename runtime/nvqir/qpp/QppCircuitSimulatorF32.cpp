@@ -0,0 +1,14 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+/// Register the single precision state vector Simulator with NVQIR.
+NVQIR_REGISTER_SIMULATOR(nvqir::QppCircuitSimulator<Eigen::VectorXcf>, qpp_f32)
+
+#undef __NVQIR_QPP_TOGGLE_CREATE
@@ -11,13 +11,189 @@
 
 namespace {
 
+/// @brief Return the superoperator sum_k K_k (x) conj(K_k) of the Kraus
+/// operators, i.e. the matrix of rho -> sum_k K_k rho K_k^dag acting on the
+/// row index bits and then the column index bits of rho. It is dense and
+/// row-major, like gate matrices. The kraus_op data is column-major.
+std::vector<std::complex<double>>
+toSuperOperator(const std::vector<cudaq::kraus_op> &ops) {
+  const std::size_t d = ops.front().nRows;
+  const std::size_t dim = d * d;
+  std::vector<std::complex<double>> superOp(dim * dim, 0.0);
+  for (auto &op : ops)
+    for (std::size_t r = 0; r < d; r++)
+      for (std::size_t c = 0; c < d; c++)
+        for (std::size_t r2 = 0; r2 < d; r2++)
+          for (std::size_t c2 = 0; c2 < d; c2++)
+            superOp[(r * d + c) * dim + r2 * d + c2] +=
+                op.data[r2 * d + r] * std::conj(op.data[c2 * d + c]);
+  return superOp;
+}
+
+/// @brief Return the product of the dense row-major dim x dim matrices.
+std::vector<std::complex<double>>
+multiply(const std::vector<std::complex<double>> &a,
+         const std::vector<std::complex<double>> &b, std::size_t dim) {
+  std::vector<std::complex<double>> product(dim * dim, 0.0);
+  for (std::size_t r = 0; r < dim; r++)
+    for (std::size_t k = 0; k < dim; k++)
+      for (std::size_t c = 0; c < dim; c++)
+        product[r * dim + c] += a[r * dim + k] * b[k * dim + c];
+  return product;
+}
+
 /// @brief The QppNoiseCircuitSimulator further specializes the
 /// QppCircuitSimulator to use a density matrix representation of the state.
 /// This class directly enables a simple noise modeling capability for CUDA
 /// Quantum.
+///
+/// Gates and Kraus channels are applied in place. The column-major density
+/// matrix is viewed as a vector on 2n bits, where the bits of the row index
+/// are the low n bits and those of the column index the high n bits. A gate
+/// U is then applied as U on the row bits and conj(U) on the column bits,
+/// and a channel as its superoperator on both. The superoperators of each
+/// noise model entry are computed once and cached, and a noisy gate is fused
+/// with its channels into a single superoperator.
 class QppNoiseCircuitSimulator : public nvqir::QppCircuitSimulator<qpp::cmat> {
 
 protected:
+  /// The version of the noise model the cached superoperators belong to
+  std::size_t superOperatorsVersion = 0;
+
+  /// The superoperator of all Kraus channels of each gate name and qubits
+  /// of the noise model, empty if there are none.
+  std::unordered_map<std::string, std::vector<std::complex<double>>>
+      superOperators;
+
+  /// @brief Return the bit positions of the given qubits in the row index
+  /// of the vectorized density matrix.
+  std::vector<std::size_t> toRowBits(const std::vector<std::size_t> &qubits) {
+    const auto nQubits = stateNumQubits();
+    std::vector<std::size_t> bits;
+    for (auto q : qubits)
+      bits.push_back(bigEndian(nQubits, q));
+    return bits;
+  }
+
+  /// @brief Return the bit positions of the given qubits in the column index
+  /// of the vectorized density matrix.
+  std::vector<std::size_t>
+  toColumnBits(const std::vector<std::size_t> &qubits) {
+    const auto nQubits = stateNumQubits();
+    auto bits = toRowBits(qubits);
+    for (auto &bit : bits)
+      bit += nQubits;
+    return bits;
+  }
+
+  /// @brief Return the cached superoperator of the Kraus channels specified
+  /// for the given gate name and qubits, computing it on first use.
+  const std::vector<std::complex<double>> &
+  getSuperOperator(const std::string_view gateName,
+                   const std::vector<std::size_t> &qubits) {
+    auto &noiseModel = *executionContext->noiseModel;
+    if (noiseModel.get_version() != superOperatorsVersion) {
+      superOperators.clear();
+      superOperatorsVersion = noiseModel.get_version();
+    }
+
+    std::string key(gateName);
+    for (auto q : qubits)
+      key += ";" + std::to_string(q);
+    auto iter = superOperators.find(key);
+    if (iter != superOperators.end())
+      return iter->second;
+
+    // Compose the superoperators of all channels into one
+    std::vector<std::complex<double>> superOp;
+    const std::size_t dim = 1ULL << (2 * qubits.size());
+    for (auto &channel :
+         noiseModel.get_channels(std::string(gateName), qubits)) {
+      auto channelSuperOp = toSuperOperator(channel.get_ops());
+      superOp = superOp.empty() ? std::move(channelSuperOp)
+                                : multiply(channelSuperOp, superOp, dim);
+    }
+    return superOperators.emplace(key, std::move(superOp)).first->second;
+  }
+
+  /// @brief Apply the superoperator on the given qubits to the density
+  /// matrix in place.
+  void applySuperOperator(const std::vector<std::complex<double>> &superOp,
+                          const std::vector<std::size_t> &qubits) {
+    auto bits = toRowBits(qubits);
+    auto columnBits = toColumnBits(qubits);
+    bits.insert(bits.end(), columnBits.begin(), columnBits.end());
+    nvqir::applyStateVectorGate(state.data(), 2 * stateNumQubits(),
+                                superOp.data(), {}, bits);
+  }
+
+  /// @brief Apply U rho U^dag in place, as U on the row bits and conj(U) on
+  /// the column bits of the density matrix.
+  void applyGate(const GateApplicationTask &task) override {
+    const auto nBits = 2 * stateNumQubits();
+    nvqir::applyStateVectorGate(state.data(), nBits, task.matrix.data(),
+                                toRowBits(task.controls),
+                                toRowBits(task.targets));
+    std::vector<std::complex<double>> conjugate(task.matrix.size());
+    std::transform(task.matrix.begin(), task.matrix.end(), conjugate.begin(),
+                   [](auto &el) { return std::conj(el); });
+    nvqir::applyStateVectorGate(state.data(), nBits, conjugate.data(),
+                                toColumnBits(task.controls),
+                                toColumnBits(task.targets));
+  }
+
+  /// @brief Apply the gate followed by the Kraus channels the noise model
+  /// specifies for it, as a single superoperator on its control and target
+  /// qubits.
+  void applyNoisyGate(const GateApplicationTask &task) {
+    std::vector<std::size_t> qubits{task.controls.begin(),
+                                    task.controls.end()};
+    qubits.insert(qubits.end(), task.targets.begin(), task.targets.end());
+    const auto &channelsSuperOp = getSuperOperator(task.operationName, qubits);
+    if (channelsSuperOp.empty()) {
+      applyGate(task);
+      return;
+    }
+
+    // The unitary of the controlled gate on all of its qubits, the controls
+    // are the most significant bits of the matrix index.
+    const std::size_t d = 1ULL << qubits.size();
+    const std::size_t targetsDim = 1ULL << task.targets.size();
+    const std::size_t offset = d - targetsDim;
+    std::vector<std::complex<double>> unitary(d * d, 0.0);
+    for (std::size_t i = 0; i < offset; i++)
+      unitary[i * d + i] = 1.0;
+    for (std::size_t r = 0; r < targetsDim; r++)
+      for (std::size_t c = 0; c < targetsDim; c++)
+        unitary[(offset + r) * d + offset + c] =
+            task.matrix[r * targetsDim + c];
+
+    const std::size_t dim = d * d;
+    std::vector<std::complex<double>> gateSuperOp(dim * dim);
+    for (std::size_t r = 0; r < d; r++)
+      for (std::size_t c = 0; c < d; c++)
+        for (std::size_t r2 = 0; r2 < d; r2++)
+          for (std::size_t c2 = 0; c2 < d; c2++)
+            gateSuperOp[(r * d + c) * dim + r2 * d + c2] =
+                unitary[r * d + r2] * std::conj(unitary[c * d + c2]);
+
+    applySuperOperator(multiply(channelsSuperOp, gateSuperOp, dim), qubits);
+  }
+
+  /// @brief With a noise model, apply each queued gate fused with its Kraus
+  /// channels.
+  void flushGateQueueImpl() override {
+    if (!executionContext || !executionContext->noiseModel) {
+      QppCircuitSimulator::flushGateQueueImpl();
+      return;
+    }
+
+    while (!gateQueue.empty()) {
+      applyNoisyGate(gateQueue.front());
+      gateQueue.pop_front();
+    }
+  }
+
   /// @brief If we have a noise model, apply any user-specified
   /// kraus_channels for the given gate name on the provided qubits.
   /// @param gateName
@@ -32,32 +208,26 @@ protected:
     if (!executionContext->noiseModel)
       return;
 
-    // Get the name as a string
-    std::string gName(gateName);
-
-    // Get the Kraus channels specified for this gate and qubits
-    auto krausChannels =
-        executionContext->noiseModel->get_channels(gName, qubits);
+    // Get the superoperator of the Kraus channels for this gate and qubits
+    const auto &superOp = getSuperOperator(gateName, qubits);
 
     // If none, do nothing
-    if (krausChannels.empty())
+    if (superOp.empty())
       return;
 
-    cudaq::info("Applying {} kraus channels to qubits {}", krausChannels.size(),
-                qubits);
-
-    for (auto &channel : krausChannels) {
-      // Map our kraus ops to the qpp::cmat
-      std::vector<qpp::cmat> K;
-      auto ops = channel.get_ops();
-      std::transform(
-          ops.begin(), ops.end(), std::back_inserter(K), [&](auto &el) {
-            return Eigen::Map<qpp::cmat>(el.data.data(), el.nRows, el.nCols);
-          });
+    cudaq::info("Applying kraus channels to qubits {}", qubits);
+    applySuperOperator(superOp, qubits);
+  }
 
-      // Apply K rho Kdag
-      state = qpp::apply(state, K, qubits);
-    }
+  /// @brief Grow the density matrix by `count` qubits in the zero state,
+  /// rho (x) |0...0><0...0|. The new qubits are the low order bits of the
+  /// row and column indices.
+  void growDensityMatrix(std::size_t count) {
+    qpp::cmat grown = qpp::cmat::Zero(stateDimension, stateDimension);
+    for (Eigen::Index c = 0; c < state.cols(); c++)
+      for (Eigen::Index r = 0; r < state.rows(); r++)
+        grown(r << count, c << count) = state(r, c);
+    state = std::move(grown);
   }
 
   /// @brief Grow the density matrix by one qubit.
@@ -69,12 +239,20 @@ protected:
       return;
     }
 
-    auto prevDim = 1UL << (nQubitsAllocated - 1);
-    state.conservativeResize(stateDimension, stateDimension);
-    for (std::size_t i = prevDim; i < stateDimension; i++) {
-      state.col(i).setZero();
-      state.row(i).setZero();
-    }
+    growDensityMatrix(1);
+  }
+
+  /// @brief Trace out the qubit with the highest index, the least
+  /// significant bit of the row and column indices, by summing the elements
+  /// where it is 0 on both sides with those where it is 1 on both sides.
+  void removeQubitFromState() override {
+    const Eigen::Index half = state.rows() / 2;
+    for (Eigen::Index c = 0; c < half; c++)
+      for (Eigen::Index r = 0; r < half; r++)
+        state.data()[r + c * half] =
+            state(2 * r, 2 * c) + state(2 * r + 1, 2 * c + 1);
+    qpp::cmat compacted = Eigen::Map<qpp::cmat>(state.data(), half, half);
+    state = std::move(compacted);
   }
 
 public:
@@ -98,24 +276,39 @@ public:
       return qubits;
     }
 
+    // Deallocated qubits still in the state are reused, only grow the state
+    // for the new highest indices.
     auto oldNQ = nQubitsAllocated;
-    nQubitsAllocated += count;
+    for (auto q : qubits)
+      nQubitsAllocated = std::max(nQubitsAllocated, q + 1);
+    if (nQubitsAllocated == oldNQ)
+      return qubits;
     stateDimension = calculateStateDim(nQubitsAllocated);
-
-    auto prevDim = 1ULL << oldNQ;
-    state.conservativeResize(stateDimension, stateDimension);
-    for (std::size_t i = prevDim; i < stateDimension; i++) {
-      state.col(i).setZero();
-      state.row(i).setZero();
-    }
+    growDensityMatrix(nQubitsAllocated - oldNQ);
     return qubits;
   }
 
+  /// @brief Copy the density matrix in row-major order, the qpp::cmat
+  /// storage is column-major.
   cudaq::State getStateData() override {
     flushGateQueue();
     // There has to be at least one copy
-    return cudaq::State{{stateDimension, stateDimension},
-                        {state.data(), state.data() + state.size()}};
+    std::vector<std::complex<double>> data(state.size());
+    Eigen::Map<Eigen::Matrix<std::complex<double>, Eigen::Dynamic,
+                             Eigen::Dynamic, Eigen::RowMajor>>(
+        data.data(), state.rows(), state.cols()) = state;
+    return cudaq::State{{stateDimension, stateDimension}, std::move(data)};
+  }
+
+  /// @brief Move the density matrix into the returned handle. It is
+  /// transposed in place, so that its column-major storage holds the
+  /// density matrix in row-major order.
+  cudaq::StateHandle releaseStateData() override {
+    auto owner = std::make_shared<qpp::cmat>(std::move(state));
+    owner->transposeInPlace();
+    state = qpp::cmat();
+    return {{stateDimension, stateDimension},
+            std::shared_ptr<std::complex<double>>(owner, owner->data())};
   }
 };
 
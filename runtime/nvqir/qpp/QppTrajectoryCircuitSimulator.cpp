@@ -0,0 +1,271 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+
+namespace {
+
+/// @brief The default maximum number of trajectories simulated for a
+/// sampling or observe task, CUDAQ_MAX_TRAJECTORIES overrides it.
+inline constexpr std::size_t DefaultMaxTrajectories = 1000;
+
+/// @brief The QppTrajectoryCircuitSimulator further specializes the
+/// QppCircuitSimulator to simulate noise with quantum trajectories
+/// (Monte-Carlo wavefunction) on a state vector. Each Kraus channel of the
+/// noise model is applied by drawing one of its Kraus operators with its
+/// probability. Sampling tasks replay the recorded noisy circuit on
+/// independent trajectories and aggregate their results, so the memory of a
+/// noisy simulation is that of a state vector per thread rather than the 4^n
+/// density matrix of the dm backend.
+class QppTrajectoryCircuitSimulator
+    : public nvqir::QppCircuitSimulator<qpp::ket> {
+protected:
+  using Base = nvqir::QppCircuitSimulator<qpp::ket>;
+
+  /// @brief An operation of the recorded circuit, either a gate or a noise
+  /// channel given by its Kraus operators. Matrices are dense and row-major.
+  struct CircuitOperation {
+    std::vector<std::vector<std::complex<double>>> matrices;
+    std::vector<std::size_t> controls;
+    std::vector<std::size_t> targets;
+    bool isChannel = false;
+  };
+
+  /// @brief The operations applied to the state since it was allocated
+  std::vector<CircuitOperation> circuit;
+
+  /// @brief False if the state was evolved by an operation that cannot be
+  /// replayed (a measurement, or a gate applied without a noise model).
+  bool canReplay = true;
+
+  /// @brief The maximum number of trajectories of a sampling task.
+  std::size_t maxTrajectories = DefaultMaxTrajectories;
+
+  /// @brief Return true if the current execution context has a noise model,
+  /// the operations are then recorded for replay.
+  bool hasNoiseModel() const {
+    return executionContext && executionContext->noiseModel;
+  }
+
+  /// @brief Apply the recorded circuit to the given trajectory state.
+  void replayCircuit(std::complex<double> *trajectory, std::size_t nQubits,
+                     std::mt19937_64 &engine) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::size_t> controls, targets;
+    for (auto &operation : circuit) {
+      controls.clear();
+      targets.clear();
+      for (auto c : operation.controls)
+        controls.push_back(bigEndian(nQubits, c));
+      for (auto t : operation.targets)
+        targets.push_back(bigEndian(nQubits, t));
+      if (operation.isChannel)
+        nvqir::applyKrausChannel(trajectory, nQubits, operation.matrices,
+                                 targets, uniform(engine));
+      else
+        nvqir::applyStateVectorGate(trajectory, nQubits,
+                                    operation.matrices[0].data(), controls,
+                                    targets);
+    }
+  }
+
+  void applyGate(const GateApplicationTask &task) override {
+    Base::applyGate(task);
+    if (!hasNoiseModel()) {
+      canReplay = false;
+      return;
+    }
+    circuit.push_back({{task.matrix}, task.controls, task.targets, false});
+  }
+
+  /// @brief If we have a noise model, apply any user-specified
+  /// kraus_channels for the given gate name on the provided qubits, drawing
+  /// one Kraus operator of each channel.
+  void applyNoiseChannel(const std::string_view gateName,
+                         const std::vector<std::size_t> &qubits) override {
+    if (!hasNoiseModel())
+      return;
+
+    // Get the Kraus channels specified for this gate and qubits
+    std::string gName(gateName);
+    auto krausChannels =
+        executionContext->noiseModel->get_channels(gName, qubits);
+    if (krausChannels.empty())
+      return;
+
+    cudaq::info("Applying {} kraus channels to qubits {}", krausChannels.size(),
+                qubits);
+
+    const auto nQubits = stateNumQubits();
+    std::vector<std::size_t> targets;
+    for (auto q : qubits)
+      targets.push_back(bigEndian(nQubits, q));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (auto &channel : krausChannels) {
+      // The kraus_op data is column-major, like the qpp::cmat of the dm
+      // backend, transpose it to the row-major gate convention.
+      CircuitOperation operation{{}, {}, qubits, true};
+      for (auto &op : channel.get_ops()) {
+        std::vector<std::complex<double>> matrix(op.data.size());
+        for (std::size_t r = 0; r < op.nRows; r++)
+          for (std::size_t c = 0; c < op.nCols; c++)
+            matrix[r * op.nCols + c] = op.data[c * op.nRows + r];
+        operation.matrices.push_back(std::move(matrix));
+      }
+
+      nvqir::applyKrausChannel(
+          state.data(), nQubits, operation.matrices, targets,
+          uniform(qpp::RandomDevices::get_instance().get_prng()));
+      circuit.push_back(std::move(operation));
+    }
+  }
+
+  /// @brief Measurements collapse this trajectory, the circuit can no
+  /// longer be replayed from the zero state.
+  bool measureQubit(const std::size_t qubitIdx) override {
+    canReplay = false;
+    return Base::measureQubit(qubitIdx);
+  }
+
+  /// @brief Reset the qubit state and the recorded circuit.
+  void resetQubitStateImpl() override {
+    Base::resetQubitStateImpl();
+    circuit.clear();
+    canReplay = true;
+  }
+
+public:
+  QppTrajectoryCircuitSimulator() {
+    if (auto *envVal = std::getenv("CUDAQ_MAX_TRAJECTORIES")) {
+      const std::string message = "Invalid CUDAQ_MAX_TRAJECTORIES "
+                                  "environment variable, must be a positive "
+                                  "integer.";
+      try {
+        maxTrajectories = std::stoul(envVal);
+      } catch (...) {
+        throw std::runtime_error(message);
+      }
+      if (maxTrajectories == 0)
+        throw std::runtime_error(message);
+    }
+  }
+  virtual ~QppTrajectoryCircuitSimulator() = default;
+  std::string name() const override { return "trajectory"; }
+
+  /// @brief Noisy expectation values are averaged over trajectories, they
+  /// cannot be computed exactly from a single state vector.
+  bool canHandleObserve() override { return false; }
+
+  /// @brief Batched observe and observe-gradient tasks would ignore the
+  /// noise model.
+  bool canHandleObserveBatch() override { return false; }
+  bool canHandleObserveGradient() override { return false; }
+
+  /// @brief Sample the noisy state. With a noise model, the shots are split
+  /// over up to CUDAQ_MAX_TRAJECTORIES independent trajectories of the
+  /// recorded circuit, which run in parallel, and the counts and expectation
+  /// values of all trajectories are aggregated. The current state is the
+  /// first trajectory.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &measuredBits,
+                                const int shots) override {
+    flushGateQueue();
+    const std::size_t nTrajectories =
+        shots > 0 ? std::min<std::size_t>(shots, maxTrajectories)
+                  : maxTrajectories;
+    if (!hasNoiseModel() || !canReplay ||
+        executionContext->hasConditionalsOnMeasureResults ||
+        nTrajectories < 2)
+      return Base::sample(measuredBits, shots);
+
+    cudaq::info("Sampling {} trajectories of {} operations.", nTrajectories,
+                circuit.size());
+    const auto nQubits = stateNumQubits();
+    const std::size_t dim = 1ULL << nQubits;
+    std::vector<std::size_t> bits;
+    for (auto q : measuredBits)
+      bits.push_back(bigEndian(nQubits, q));
+    const std::size_t nBits = bits.size();
+
+    // Seed each trajectory from the simulator random engine, so that
+    // results do not depend on the thread scheduling.
+    auto &prng = qpp::RandomDevices::get_instance().get_prng();
+    std::vector<std::uint64_t> seeds(nTrajectories);
+    for (auto &seed : seeds)
+      seed = prng();
+
+    // Run trajectories in parallel when their states are small, otherwise
+    // one after the other with the state vector kernels parallelized.
+    [[maybe_unused]] const bool parallel =
+        nQubits < nvqir::ParallelKernelQubitThreshold;
+    std::vector<std::size_t> outcomeCounts(1ULL << nBits, 0);
+    double expectationValue = 0.0;
+#pragma omp parallel if (parallel)
+    {
+      std::vector<std::size_t> localCounts(outcomeCounts.size(), 0);
+      double localExpectation = 0.0;
+      qpp::ket trajectory;
+#pragma omp for schedule(dynamic) nowait
+      for (std::size_t t = 0; t < nTrajectories; t++) {
+        std::mt19937_64 engine(seeds[t]);
+        const std::complex<double> *amplitudes = state.data();
+        if (t > 0) {
+          trajectory = qpp::ket::Zero(dim);
+          trajectory(0) = 1.0;
+          replayCircuit(trajectory.data(), nQubits, engine);
+          amplitudes = trajectory.data();
+        }
+
+        const auto probabilities =
+            nvqir::getMarginalProbabilities(amplitudes, nQubits, bits);
+        for (std::size_t o = 0; o < probabilities.size(); o++)
+          localExpectation +=
+              (std::popcount(o) % 2 ? -1.0 : 1.0) * probabilities[o];
+        if (shots > 0) {
+          const std::size_t trajectoryShots =
+              shots / nTrajectories + (t < shots % nTrajectories);
+          const auto counts = nvqir::sampleOutcomeCounts(
+              probabilities, trajectoryShots, engine);
+          for (std::size_t o = 0; o < counts.size(); o++)
+            localCounts[o] += counts[o];
+        }
+      }
+#pragma omp critical
+      {
+        for (std::size_t o = 0; o < outcomeCounts.size(); o++)
+          outcomeCounts[o] += localCounts[o];
+        expectationValue += localExpectation;
+      }
+    }
+    expectationValue /= nTrajectories;
+
+    if (shots < 1) {
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    cudaq::ExecutionResult counts(expectationValue);
+    std::string bitstring(nBits, '0');
+    for (std::size_t o = 0; o < outcomeCounts.size(); o++) {
+      if (outcomeCounts[o] == 0)
+        continue;
+      for (std::size_t j = 0; j < nBits; j++)
+        bitstring[j] = (o >> (nBits - 1 - j)) & 1 ? '1' : '0';
+      counts.appendResult(bitstring, outcomeCounts[o]);
+    }
+    return counts;
+  }
+
+  NVQIR_SIMULATOR_CLONE_IMPL(QppTrajectoryCircuitSimulator)
+};
+
+} // namespace
+
+/// Register this Simulator with NVQIR.
+NVQIR_REGISTER_SIMULATOR(QppTrajectoryCircuitSimulator, trajectory)
+#undef __NVQIR_QPP_TOGGLE_CREATE
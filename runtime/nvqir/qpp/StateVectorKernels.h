@@ -0,0 +1,714 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// This file provides in-place gate application kernels for dense state
+/// vectors. All qubits passed to these kernels are bit positions in the
+/// amplitude index (i.e. callers are responsible for any endianness
+/// conversion). Gate matrices are dense, row-major, and the first target is
+/// the most significant bit of the local matrix index, which is the same
+/// convention used by qpp::applyCTRL.
+
+namespace nvqir {
+
+/// @brief State vectors with at least this many qubits will have gate
+/// applications parallelized with OpenMP. Smaller states are not worth the
+/// thread synchronization overhead.
+inline constexpr std::size_t ParallelKernelQubitThreshold = 14;
+
+/// @brief The default maximum number of qubits of a fused gate. A dense
+/// gate on k qubits costs 2^k complex multiply-adds per amplitude, so larger
+/// fused gates trade memory passes for arithmetic.
+inline constexpr std::size_t DefaultMaxFusedQubits = 2;
+
+/// @brief The default number of low order qubits of the amplitude index that
+/// gates are remapped onto, and that the tiles of applyTiledGates() span.
+/// The amplitudes spanned by 16 qubits (1 MiB in double precision) stay in
+/// the L2 cache of most CPUs.
+inline constexpr std::size_t DefaultLocalityQubits = 16;
+
+/// @brief A qubit is remapped onto a low order bit if at least this many
+/// more queued gates target it than the qubit it is swapped with, so that the
+/// swap and the swap back are amortized.
+inline constexpr std::size_t LocalityRemapMinGates = 4;
+
+namespace details {
+
+/// @brief Return true if a gate kernel on a state vector of `nQubits` should
+/// be parallelized with OpenMP, i.e. the state is large enough and the kernel
+/// is not already run by a thread of a parallel region, e.g. on one tile of
+/// applyTiledGates().
+inline bool parallelizeGateKernel(std::size_t nQubits) {
+#ifdef _OPENMP
+  if (omp_in_parallel())
+    return false;
+#endif
+  return nQubits >= ParallelKernelQubitThreshold;
+}
+
+/// @brief Complex multiplication written out on the real and imaginary parts.
+/// std::complex operator* carries NaN / Inf recovery branches that prevent
+/// the compiler from vectorizing the amplitude loops.
+template <typename ScalarType>
+inline std::complex<ScalarType> cmul(const std::complex<ScalarType> &a,
+                                     const std::complex<ScalarType> &b) {
+  return {a.real() * b.real() - a.imag() * b.imag(),
+          a.real() * b.imag() + a.imag() * b.real()};
+}
+
+/// @brief Insert a zero bit into `index` at each of the given bit positions.
+/// The positions must be sorted in ascending order.
+inline std::size_t insertZeroBits(std::size_t index,
+                                  const std::vector<std::size_t> &sortedBits) {
+  for (auto bit : sortedBits) {
+    const std::size_t lowMask = (1ULL << bit) - 1;
+    index = (index & lowMask) | ((index & ~lowMask) << 1);
+  }
+  return index;
+}
+
+/// @brief Invoke `functor(baseIdx)` for every amplitude index that has a zero
+/// at each of the given bit positions and a one at each bit of `setMask`.
+/// The loop is split into an outer loop over the index bits above the lowest
+/// fixed bit and a contiguous inner loop over the bits below it, and the
+/// larger of the two is the one distributed over OpenMP threads. The inner
+/// loop is contiguous in memory so that it can be vectorized.
+template <typename Functor>
+void forEachAmplitudeGroup(std::size_t nQubits,
+                           const std::vector<std::size_t> &sortedBits,
+                           std::size_t setMask, Functor &&functor) {
+  assert(!sortedBits.empty() && sortedBits.back() < nQubits &&
+         "Invalid qubit bit positions passed to state vector kernel.");
+  const std::size_t innerSize = 1ULL << sortedBits.front();
+  const std::size_t outerSize =
+      1ULL << (nQubits - sortedBits.size() - sortedBits.front());
+  [[maybe_unused]] const bool parallel = parallelizeGateKernel(nQubits);
+
+  if (outerSize >= innerSize) {
+#pragma omp parallel for if (parallel)
+    for (std::size_t k = 0; k < outerSize; ++k) {
+      const std::size_t base =
+          insertZeroBits(k * innerSize, sortedBits) | setMask;
+      for (std::size_t j = 0; j < innerSize; ++j)
+        functor(base + j);
+    }
+    return;
+  }
+
+  for (std::size_t k = 0; k < outerSize; ++k) {
+    const std::size_t base =
+        insertZeroBits(k * innerSize, sortedBits) | setMask;
+#pragma omp parallel for simd if (parallel)
+    for (std::size_t j = 0; j < innerSize; ++j)
+      functor(base + j);
+  }
+}
+
+/// @brief Return the sorted bit positions of the controls and targets, and
+/// the bit mask of the controls.
+inline std::pair<std::vector<std::size_t>, std::size_t>
+getSortedBitsAndControlMask(const std::vector<std::size_t> &controls,
+                            const std::vector<std::size_t> &targets) {
+  std::vector<std::size_t> sortedBits(controls.begin(), controls.end());
+  sortedBits.insert(sortedBits.end(), targets.begin(), targets.end());
+  std::sort(sortedBits.begin(), sortedBits.end());
+  assert(std::adjacent_find(sortedBits.begin(), sortedBits.end()) ==
+             sortedBits.end() &&
+         "Control and target qubits must be unique.");
+  std::size_t controlMask = 0;
+  for (auto c : controls)
+    controlMask |= 1ULL << c;
+  return {sortedBits, controlMask};
+}
+} // namespace details
+
+/// @brief Apply the 2x2 matrix to the `target` bit of the state vector, in
+/// place, conditioned on all `controls` bits being set.
+template <typename ScalarType>
+void applyOneQubitGate(std::complex<ScalarType> *state, std::size_t nQubits,
+                       const std::complex<ScalarType> *matrix,
+                       const std::vector<std::size_t> &controls,
+                       std::size_t target) {
+  const auto [sortedBits, controlMask] =
+      details::getSortedBitsAndControlMask(controls, {target});
+  const std::size_t targetBit = 1ULL << target;
+  const auto m00 = matrix[0], m01 = matrix[1], m10 = matrix[2],
+             m11 = matrix[3];
+  details::forEachAmplitudeGroup(
+      nQubits, sortedBits, controlMask, [&](std::size_t i0) {
+        const std::size_t i1 = i0 | targetBit;
+        const auto a0 = state[i0], a1 = state[i1];
+        state[i0] = details::cmul(m00, a0) + details::cmul(m01, a1);
+        state[i1] = details::cmul(m10, a0) + details::cmul(m11, a1);
+      });
+}
+
+/// @brief Apply the 4x4 matrix to the `target0` and `target1` bits of the
+/// state vector, in place, conditioned on all `controls` bits being set.
+/// `target0` is the most significant bit of the matrix index.
+template <typename ScalarType>
+void applyTwoQubitGate(std::complex<ScalarType> *state, std::size_t nQubits,
+                       const std::complex<ScalarType> *matrix,
+                       const std::vector<std::size_t> &controls,
+                       std::size_t target0, std::size_t target1) {
+  const auto [sortedBits, controlMask] =
+      details::getSortedBitsAndControlMask(controls, {target0, target1});
+  const std::size_t bit0 = 1ULL << target0, bit1 = 1ULL << target1;
+  std::complex<ScalarType> m[16];
+  std::copy(matrix, matrix + 16, m);
+  details::forEachAmplitudeGroup(
+      nQubits, sortedBits, controlMask, [&](std::size_t i00) {
+        const std::size_t idx[4] = {i00, i00 | bit1, i00 | bit0,
+                                    i00 | bit0 | bit1};
+        const std::complex<ScalarType> a[4] = {state[idx[0]], state[idx[1]],
+                                               state[idx[2]], state[idx[3]]};
+        for (std::size_t r = 0; r < 4; ++r)
+          state[idx[r]] = details::cmul(m[4 * r], a[0]) +
+                          details::cmul(m[4 * r + 1], a[1]) +
+                          details::cmul(m[4 * r + 2], a[2]) +
+                          details::cmul(m[4 * r + 3], a[3]);
+      });
+}
+
+/// @brief Apply a general dense 2^k x 2^k matrix to the k `targets` bits of
+/// the state vector, in place, conditioned on all `controls` bits being set.
+template <typename ScalarType>
+void applyDenseGate(std::complex<ScalarType> *state, std::size_t nQubits,
+                    const std::complex<ScalarType> *matrix,
+                    const std::vector<std::size_t> &controls,
+                    const std::vector<std::size_t> &targets) {
+  const auto [sortedBits, controlMask] =
+      details::getSortedBitsAndControlMask(controls, targets);
+  const std::size_t nTargets = targets.size();
+  const std::size_t localDim = 1ULL << nTargets;
+
+  // Offset of each local matrix index from the group base index.
+  std::vector<std::size_t> offsets(localDim, 0);
+  for (std::size_t m = 0; m < localDim; ++m)
+    for (std::size_t j = 0; j < nTargets; ++j)
+      if (m & (1ULL << (nTargets - 1 - j)))
+        offsets[m] |= 1ULL << targets[j];
+
+  const std::size_t nGroups = 1ULL << (nQubits - sortedBits.size());
+  [[maybe_unused]] const bool parallel =
+      details::parallelizeGateKernel(nQubits);
+#pragma omp parallel if (parallel)
+  {
+    std::vector<std::complex<ScalarType>> local(localDim);
+#pragma omp for
+    for (std::size_t k = 0; k < nGroups; ++k) {
+      const std::size_t base =
+          details::insertZeroBits(k, sortedBits) | controlMask;
+      for (std::size_t m = 0; m < localDim; ++m)
+        local[m] = state[base + offsets[m]];
+      for (std::size_t r = 0; r < localDim; ++r) {
+        std::complex<ScalarType> sum = 0.;
+        const auto *row = matrix + r * localDim;
+        for (std::size_t c = 0; c < localDim; ++c)
+          sum += details::cmul(row[c], local[c]);
+        state[base + offsets[r]] = sum;
+      }
+    }
+  }
+}
+
+/// @brief Apply the gate matrix to the state vector in place, dispatching to
+/// the most specialized kernel for the number of targets.
+template <typename ScalarType>
+void applyStateVectorGate(std::complex<ScalarType> *state, std::size_t nQubits,
+                          const std::complex<ScalarType> *matrix,
+                          const std::vector<std::size_t> &controls,
+                          const std::vector<std::size_t> &targets) {
+  if (targets.size() == 1)
+    applyOneQubitGate(state, nQubits, matrix, controls, targets[0]);
+  else if (targets.size() == 2)
+    applyTwoQubitGate(state, nQubits, matrix, controls, targets[0],
+                      targets[1]);
+  else
+    applyDenseGate(state, nQubits, matrix, controls, targets);
+}
+
+/// @brief A gate of a tiled pass, see applyTiledGates(). The `targets` and
+/// `controls` are bits of the amplitude index within a tile, the controls on
+/// the bits above the tile are folded into `highControlMask`.
+template <typename ScalarType>
+struct TiledGate {
+  std::vector<std::complex<ScalarType>> matrix;
+  std::vector<std::size_t> controls;
+  std::vector<std::size_t> targets;
+  std::size_t highControlMask = 0;
+};
+
+/// @brief Apply the gates, in order, to each tile of 2^tileQubits contiguous
+/// amplitudes of the state vector before moving on to the next tile, rather
+/// than sweeping over the whole state once per gate. This is only valid if
+/// all gates target bits below `tileQubits`: the bits above it are constant
+/// within a tile, so controls on them select whole tiles. The tiles are
+/// distributed over the OpenMP threads, a tile sized to fit in the L2 cache
+/// is then read from and written to memory once for all gates.
+template <typename ScalarType>
+void applyTiledGates(std::complex<ScalarType> *state, std::size_t nQubits,
+                     std::size_t tileQubits,
+                     const std::vector<TiledGate<ScalarType>> &gates) {
+  const std::size_t nTiles = 1ULL << (nQubits - tileQubits);
+  [[maybe_unused]] const bool parallel =
+      details::parallelizeGateKernel(nQubits);
+#pragma omp parallel for schedule(static) if (parallel)
+  for (std::size_t tile = 0; tile < nTiles; ++tile) {
+    const std::size_t base = tile << tileQubits;
+    for (auto &gate : gates)
+      if ((base & gate.highControlMask) == gate.highControlMask)
+        applyStateVectorGate(state + base, tileQubits, gate.matrix.data(),
+                             gate.controls, gate.targets);
+  }
+}
+
+/// @brief Swap the `bit0` and `bit1` bits of the amplitude index of the
+/// state vector in place, i.e. exchange the positions of two qubits in the
+/// layout of the state. Only the amplitudes where the two bits differ move.
+template <typename ScalarType>
+void swapStateVectorBits(std::complex<ScalarType> *state, std::size_t nQubits,
+                         std::size_t bit0, std::size_t bit1) {
+  if (bit0 == bit1)
+    return;
+  const std::size_t mask0 = 1ULL << bit0, mask1 = 1ULL << bit1;
+  details::forEachAmplitudeGroup(
+      nQubits, {std::min(bit0, bit1), std::max(bit0, bit1)}, mask0,
+      [&](std::size_t i) { std::swap(state[i], state[i ^ mask0 ^ mask1]); });
+}
+
+/// @brief Return the probability of measuring a one on the given `bit` of
+/// the state vector.
+template <typename ScalarType>
+double getProbabilityOfOne(const std::complex<ScalarType> *state,
+                           std::size_t nQubits, std::size_t bit) {
+  const std::size_t dim = 1ULL << nQubits;
+  const std::size_t mask = 1ULL << bit;
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+  double probability = 0.0;
+#pragma omp parallel for reduction(+ : probability) if (parallel)
+  for (std::size_t i = 0; i < dim; ++i)
+    if (i & mask)
+      probability += std::norm(state[i]);
+  return probability;
+}
+
+/// @brief Collapse the state vector onto the given measurement `result` of
+/// `bit`, which occurs with the given `probability`, and renormalize.
+template <typename ScalarType>
+void collapseQubit(std::complex<ScalarType> *state, std::size_t nQubits,
+                   std::size_t bit, bool result, double probability) {
+  const std::size_t dim = 1ULL << nQubits;
+  const std::size_t mask = 1ULL << bit;
+  const std::size_t keep = result ? mask : 0;
+  const auto scale = static_cast<ScalarType>(1.0 / std::sqrt(probability));
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+#pragma omp parallel for simd if (parallel)
+  for (std::size_t i = 0; i < dim; ++i)
+    state[i] = (i & mask) == keep ? state[i] * scale
+                                  : std::complex<ScalarType>(0.0, 0.0);
+}
+
+/// @brief Return the reduced density matrix of the given `bits` of the state
+/// vector, as a dense row-major 2^k x 2^k matrix. The first bit is the most
+/// significant bit of the matrix index.
+template <typename ScalarType>
+std::vector<std::complex<double>>
+getReducedDensityMatrix(const std::complex<ScalarType> *state,
+                        std::size_t nQubits,
+                        const std::vector<std::size_t> &bits) {
+  const std::size_t nBits = bits.size();
+  const std::size_t localDim = 1ULL << nBits;
+  std::vector<std::size_t> sortedBits(bits.begin(), bits.end());
+  std::sort(sortedBits.begin(), sortedBits.end());
+
+  // Offset of each local matrix index from the group base index.
+  std::vector<std::size_t> offsets(localDim, 0);
+  for (std::size_t m = 0; m < localDim; ++m)
+    for (std::size_t j = 0; j < nBits; ++j)
+      if (m & (1ULL << (nBits - 1 - j)))
+        offsets[m] |= 1ULL << bits[j];
+
+  const std::size_t nGroups = 1ULL << (nQubits - nBits);
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+  std::vector<std::complex<double>> rho(localDim * localDim, 0.0);
+#pragma omp parallel if (parallel)
+  {
+    std::vector<std::complex<double>> local(localDim);
+    std::vector<std::complex<double>> localRho(localDim * localDim, 0.0);
+#pragma omp for nowait
+    for (std::size_t k = 0; k < nGroups; ++k) {
+      const std::size_t base = details::insertZeroBits(k, sortedBits);
+      for (std::size_t m = 0; m < localDim; ++m)
+        local[m] = state[base + offsets[m]];
+      for (std::size_t r = 0; r < localDim; ++r)
+        for (std::size_t c = 0; c < localDim; ++c)
+          localRho[r * localDim + c] +=
+              details::cmul(local[r], std::conj(local[c]));
+    }
+#pragma omp critical
+    for (std::size_t i = 0; i < rho.size(); ++i)
+      rho[i] += localRho[i];
+  }
+  return rho;
+}
+
+/// @brief Apply the quantum channel with the given Kraus operators (dense
+/// row-major matrices on the `targets` bits) to a single trajectory of the
+/// state vector, in place. The Kraus operator K_k is drawn with probability
+/// p_k = <psi|K_k^dag K_k|psi> using the uniform variate `u` in [0, 1), and
+/// the state becomes K_k|psi> / sqrt(p_k). Return the drawn index k.
+template <typename ScalarType>
+std::size_t applyKrausChannel(
+    std::complex<ScalarType> *state, std::size_t nQubits,
+    const std::vector<std::vector<std::complex<ScalarType>>> &krausOps,
+    const std::vector<std::size_t> &targets, double u) {
+  const std::size_t localDim = 1ULL << targets.size();
+
+  // If every K_k^dag K_k is proportional to the identity, e.g. for the
+  // depolarizing or bit flip channels, p_k does not depend on the state and
+  // no pass over the state is needed to compute it.
+  std::vector<double> probabilities(krausOps.size(), 0.0);
+  bool isStateIndependent = true;
+  for (std::size_t k = 0; k < krausOps.size(); ++k) {
+    const auto &op = krausOps[k];
+    for (std::size_t r = 0; r < localDim && isStateIndependent; ++r)
+      for (std::size_t c = 0; c < localDim; ++c) {
+        std::complex<double> element = 0.0;
+        for (std::size_t m = 0; m < localDim; ++m)
+          element += std::complex<double>(std::conj(op[m * localDim + r])) *
+                     std::complex<double>(op[m * localDim + c]);
+        if (r == 0 && c == 0)
+          probabilities[k] = element.real();
+        const double expected = r == c ? probabilities[k] : 0.0;
+        if (std::abs(element - expected) > 1e-12) {
+          isStateIndependent = false;
+          break;
+        }
+      }
+  }
+
+  if (!isStateIndependent) {
+    // p_k = Tr(K_k rho K_k^dag) with rho the reduced density matrix.
+    const auto rho = getReducedDensityMatrix(state, nQubits, targets);
+    for (std::size_t k = 0; k < krausOps.size(); ++k) {
+      const auto &op = krausOps[k];
+      double probability = 0.0;
+      for (std::size_t r = 0; r < localDim; ++r) {
+        // (K rho K^dag)_rr = sum_c (K rho)_rc conj(K_rc)
+        for (std::size_t c = 0; c < localDim; ++c) {
+          std::complex<double> kRho = 0.0;
+          for (std::size_t m = 0; m < localDim; ++m)
+            kRho += std::complex<double>(op[r * localDim + m]) *
+                    rho[m * localDim + c];
+          probability +=
+              (kRho * std::conj(std::complex<double>(op[r * localDim + c])))
+                  .real();
+        }
+      }
+      probabilities[k] = std::max(probability, 0.0);
+    }
+  }
+
+  // Draw the Kraus operator, scaling by the total probability to be robust
+  // to rounding in the state norm.
+  double total = 0.0;
+  for (auto p : probabilities)
+    total += p;
+  const double threshold = u * total;
+  std::size_t drawn = 0;
+  double cumulative = 0.0;
+  for (std::size_t k = 0; k < probabilities.size(); ++k) {
+    if (probabilities[k] <= 0.0)
+      continue;
+    drawn = k;
+    cumulative += probabilities[k];
+    if (threshold < cumulative)
+      break;
+  }
+
+  const auto scale =
+      static_cast<ScalarType>(1.0 / std::sqrt(probabilities[drawn]));
+  std::vector<std::complex<ScalarType>> matrix(krausOps[drawn]);
+  for (auto &element : matrix)
+    element *= scale;
+  applyStateVectorGate(state, nQubits, matrix.data(), {}, targets);
+  return drawn;
+}
+
+/// @brief Return <psi|P|psi> for the Pauli string P with the given X and Z
+/// bit masks (Y on bits set in both). Since P|i> = i^nY (-1)^|i & Z| |i ^ X>,
+/// this is a single sweep over the state vector with no basis change.
+template <typename ScalarType>
+double getPauliExpectation(const std::complex<ScalarType> *state,
+                           std::size_t nQubits, std::size_t xMask,
+                           std::size_t zMask) {
+  const std::size_t dim = 1ULL << nQubits;
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+  double real = 0.0, imag = 0.0;
+#pragma omp parallel for reduction(+ : real, imag) if (parallel)
+  for (std::size_t i = 0; i < dim; ++i) {
+    const auto product = details::cmul(std::conj(state[i ^ xMask]), state[i]);
+    const double sign = std::popcount(i & zMask) % 2 ? -1.0 : 1.0;
+    real += sign * product.real();
+    imag += sign * product.imag();
+  }
+
+  // Multiply by i^nY and keep the real part.
+  switch (std::popcount(xMask & zMask) % 4) {
+  case 0:
+    return real;
+  case 1:
+    return -imag;
+  case 2:
+    return -real;
+  default:
+    return imag;
+  }
+}
+
+/// @brief Add coefficient * P|psi> to `result`, for the Pauli string P with
+/// the given X and Z bit masks (see getPauliExpectation).
+template <typename ScalarType>
+void addPauliProduct(std::complex<ScalarType> *result,
+                     const std::complex<ScalarType> *state, std::size_t nQubits,
+                     std::size_t xMask, std::size_t zMask,
+                     std::complex<double> coefficient) {
+  // Fold i^nY into the coefficient.
+  static const std::complex<double> phases[4] = {1., {0., 1.}, -1., {0., -1.}};
+  const auto factor = coefficient * phases[std::popcount(xMask & zMask) % 4];
+  const std::complex<ScalarType> scaled(factor.real(), factor.imag());
+  const std::size_t dim = 1ULL << nQubits;
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+#pragma omp parallel for if (parallel)
+  for (std::size_t i = 0; i < dim; ++i) {
+    const auto product = details::cmul(scaled, state[i]);
+    result[i ^ xMask] += std::popcount(i & zMask) % 2 ? -product : product;
+  }
+}
+
+/// @brief Apply a gate to a batch of state vectors, in place, with a
+/// different matrix for each copy. The states are interleaved, amplitude i
+/// of copy b is at index i * batchSize + b, and so are the matrices, element
+/// (r, c) of the matrix of copy b is at index (r * 2^k + c) * batchSize + b.
+/// The innermost loops run over the copies, contiguous in memory, so they
+/// vectorize even for single qubit gates.
+template <typename ScalarType>
+void applyBatchedGate(std::complex<ScalarType> *states, std::size_t nQubits,
+                      std::size_t batchSize,
+                      const std::complex<ScalarType> *matrices,
+                      const std::vector<std::size_t> &controls,
+                      const std::vector<std::size_t> &targets) {
+  const auto [sortedBits, controlMask] =
+      details::getSortedBitsAndControlMask(controls, targets);
+  const std::size_t nTargets = targets.size();
+  const std::size_t localDim = 1ULL << nTargets;
+
+  // Offset of each local matrix index from the group base index.
+  std::vector<std::size_t> offsets(localDim, 0);
+  for (std::size_t m = 0; m < localDim; ++m)
+    for (std::size_t j = 0; j < nTargets; ++j)
+      if (m & (1ULL << (nTargets - 1 - j)))
+        offsets[m] |= 1ULL << targets[j];
+
+  const std::size_t nGroups = 1ULL << (nQubits - sortedBits.size());
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+#pragma omp parallel if (parallel)
+  {
+    std::vector<std::complex<ScalarType>> local(localDim * batchSize);
+#pragma omp for
+    for (std::size_t k = 0; k < nGroups; ++k) {
+      const std::size_t base =
+          details::insertZeroBits(k, sortedBits) | controlMask;
+      for (std::size_t m = 0; m < localDim; ++m)
+        std::copy_n(states + (base + offsets[m]) * batchSize, batchSize,
+                    local.data() + m * batchSize);
+      for (std::size_t r = 0; r < localDim; ++r) {
+        auto *out = states + (base + offsets[r]) * batchSize;
+        std::fill_n(out, batchSize, 0.);
+        for (std::size_t c = 0; c < localDim; ++c) {
+          const auto *m = matrices + (r * localDim + c) * batchSize;
+          const auto *in = local.data() + c * batchSize;
+#pragma omp simd
+          for (std::size_t b = 0; b < batchSize; ++b)
+            out[b] += details::cmul(m[b], in[b]);
+        }
+      }
+    }
+  }
+}
+
+/// @brief Return <psi_b|P|psi_b> for each state of the interleaved batch of
+/// state vectors (see applyBatchedGate) and the Pauli string P with the
+/// given X and Z bit masks.
+template <typename ScalarType>
+std::vector<double>
+getBatchedPauliExpectations(const std::complex<ScalarType> *states,
+                            std::size_t nQubits, std::size_t batchSize,
+                            std::size_t xMask, std::size_t zMask) {
+  const std::size_t dim = 1ULL << nQubits;
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+  std::vector<double> real(batchSize, 0.0), imag(batchSize, 0.0);
+#pragma omp parallel if (parallel)
+  {
+    std::vector<double> localReal(batchSize, 0.0), localImag(batchSize, 0.0);
+#pragma omp for
+    for (std::size_t i = 0; i < dim; ++i) {
+      const double sign = std::popcount(i & zMask) % 2 ? -1.0 : 1.0;
+      const auto *left = states + (i ^ xMask) * batchSize;
+      const auto *right = states + i * batchSize;
+#pragma omp simd
+      for (std::size_t b = 0; b < batchSize; ++b) {
+        const auto product = details::cmul(std::conj(left[b]), right[b]);
+        localReal[b] += sign * product.real();
+        localImag[b] += sign * product.imag();
+      }
+    }
+#pragma omp critical
+    for (std::size_t b = 0; b < batchSize; ++b) {
+      real[b] += localReal[b];
+      imag[b] += localImag[b];
+    }
+  }
+
+  // Multiply by i^nY and keep the real part.
+  std::vector<double> expectations(batchSize);
+  for (std::size_t b = 0; b < batchSize; ++b) {
+    switch (std::popcount(xMask & zMask) % 4) {
+    case 0:
+      expectations[b] = real[b];
+      break;
+    case 1:
+      expectations[b] = -imag[b];
+      break;
+    case 2:
+      expectations[b] = -real[b];
+      break;
+    default:
+      expectations[b] = imag[b];
+    }
+  }
+  return expectations;
+}
+
+/// @brief Return the probability of each outcome of measuring the given
+/// `bits` of the state vector, marginalized over all other bits. The first
+/// bit is the most significant bit of the outcome index.
+template <typename ScalarType>
+std::vector<double>
+getMarginalProbabilities(const std::complex<ScalarType> *state,
+                         std::size_t nQubits,
+                         const std::vector<std::size_t> &bits) {
+  const std::size_t dim = 1ULL << nQubits;
+  const std::size_t nBits = bits.size();
+  const std::size_t nOutcomes = 1ULL << nBits;
+
+  // Look-up tables mapping each byte of the amplitude index to its
+  // contribution to the outcome index.
+  const std::size_t nBytes = (nQubits + 7) / 8;
+  std::vector<std::size_t> byteToOutcome(nBytes * 256, 0);
+  for (std::size_t j = 0; j < nBits; ++j) {
+    const std::size_t byte = bits[j] / 8, offset = bits[j] % 8;
+    for (std::size_t value = 0; value < 256; ++value)
+      if (value & (1ULL << offset))
+        byteToOutcome[byte * 256 + value] |= 1ULL << (nBits - 1 - j);
+  }
+  auto getOutcome = [&](std::size_t i) {
+    std::size_t outcome = 0;
+    for (std::size_t byte = 0; byte < nBytes; ++byte)
+      outcome |= byteToOutcome[byte * 256 + ((i >> (8 * byte)) & 0xFF)];
+    return outcome;
+  };
+
+  [[maybe_unused]] const bool parallel =
+      nQubits >= ParallelKernelQubitThreshold;
+  std::vector<double> probabilities(nOutcomes, 0.0);
+  if (nBits == nQubits) {
+    // Measuring all qubits, the outcome is a permutation of the index.
+#pragma omp parallel for if (parallel)
+    for (std::size_t i = 0; i < dim; ++i)
+      probabilities[getOutcome(i)] = std::norm(state[i]);
+    return probabilities;
+  }
+
+#pragma omp parallel if (parallel)
+  {
+    std::vector<double> local(nOutcomes, 0.0);
+#pragma omp for nowait
+    for (std::size_t i = 0; i < dim; ++i)
+      local[getOutcome(i)] += std::norm(state[i]);
+#pragma omp critical
+    for (std::size_t o = 0; o < nOutcomes; ++o)
+      probabilities[o] += local[o];
+  }
+  return probabilities;
+}
+
+/// @brief Draw `shots` samples from the given outcome probabilities and
+/// return the number of times each outcome was drawn. The samples are
+/// drawn as sorted uniform variates (generated directly in sorted order from
+/// normalized exponential spacings), which are matched against the
+/// cumulative distribution in a single pass, i.e. in O(shots + outcomes).
+template <typename RandomEngine>
+std::vector<std::size_t>
+sampleOutcomeCounts(const std::vector<double> &probabilities,
+                    std::size_t shots, RandomEngine &engine) {
+  std::vector<std::size_t> counts(probabilities.size(), 0);
+  if (shots == 0 || probabilities.empty())
+    return counts;
+
+  // The k-th of n sorted uniform variates is S_k / S_{n+1}, where S_k is
+  // the running sum of i.i.d. exponential variates.
+  std::exponential_distribution<double> exponential(1.0);
+  std::vector<double> variates(shots);
+  double sum = 0.0;
+  for (auto &variate : variates) {
+    sum += exponential(engine);
+    variate = sum;
+  }
+  sum += exponential(engine);
+
+  // Scale by the total probability rather than normalizing the
+  // probabilities, to be robust to rounding in the state norm.
+  double total = 0.0;
+  for (auto p : probabilities)
+    total += p;
+  const double scale = total / sum;
+
+  std::size_t outcome = 0;
+  double cumulative = probabilities[0];
+  for (auto variate : variates) {
+    const double u = variate * scale;
+    while (u >= cumulative && outcome + 1 < probabilities.size())
+      cumulative += probabilities[++outcome];
+    counts[outcome]++;
+  }
+  return counts;
+}
+
+} // namespace nvqir
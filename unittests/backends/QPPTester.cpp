@@ -1241,3 +1241,349 @@ CUDAQ_TEST(QPPTester, checkReset) {
     EXPECT_EQ(1, qppBackend.mz(q1));
   }
 }
+
+// Check the in-place gate kernels against qpp::applyCTRL for random
+// unitaries on 1, 2, and 3 targets, with and without controls.
+CUDAQ_TEST(QPPTester, checkInPlaceGateKernels) {
+  const std::size_t num_qubits = 6;
+  std::vector<std::pair<std::vector<std::size_t>, std::vector<std::size_t>>>
+      ctrlsAndTargets{{{}, {0}},        {{}, {5}},        {{1, 4}, {2}},
+                      {{}, {3, 1}},     {{5}, {0, 4}},    {{}, {4, 0, 2}},
+                      {{3}, {5, 1, 0}}, {{0, 2}, {1, 5}}, {{2, 3, 4}, {1}}};
+  for (auto &[controls, targets] : ctrlsAndTargets) {
+    QppCircuitSimulator<qpp::ket> qppBackend;
+    qppBackend.allocateQubits(num_qubits);
+    // Start from a generic state
+    for (std::size_t i = 0; i < num_qubits; i++) {
+      qppBackend.ry(0.3 + 0.2 * i, i);
+      qppBackend.rz(0.7 - 0.1 * i, i);
+    }
+    for (std::size_t i = 0; i < num_qubits - 1; i++)
+      qppBackend.x({i}, i + 1);
+    qpp::ket initial_state = qppBackend.getStateVector();
+
+    qpp::cmat U = qpp::randU(1ULL << targets.size());
+    std::vector<std::complex<double>> matrix;
+    for (Eigen::Index r = 0; r < U.rows(); r++)
+      for (Eigen::Index c = 0; c < U.cols(); c++)
+        matrix.push_back(U(r, c));
+
+    qppBackend.applyCustomOperation(matrix, controls, targets);
+    qpp::ket want_state = qpp::applyCTRL(initial_state, U, controls, targets);
+    qpp::ket got_state = qppBackend.getStateVector();
+    EXPECT_EQ_KETS(want_state, got_state, 1e-12);
+  }
+}
+
+// Check that fusing queued gates into blocks of up to k qubits gives
+// the same state as applying the gates one at a time.
+CUDAQ_TEST(QPPTester, checkGateFusion) {
+  class FusionSimulator : public QppCircuitSimulator<qpp::ket> {
+  public:
+    FusionSimulator(std::size_t k) { maxFusedQubits = k; }
+  };
+
+  const std::size_t num_qubits = 6;
+  qpp::cmat U = qpp::randU(4);
+  std::vector<std::complex<double>> matrix;
+  for (Eigen::Index r = 0; r < U.rows(); r++)
+    for (Eigen::Index c = 0; c < U.cols(); c++)
+      matrix.push_back(U(r, c));
+
+  auto runCircuit = [&](std::size_t k) {
+    FusionSimulator qppBackend(k);
+    qppBackend.allocateQubits(num_qubits);
+    for (std::size_t layer = 0; layer < 3; layer++) {
+      for (std::size_t i = 0; i < num_qubits; i++) {
+        qppBackend.ry(0.3 + 0.2 * i + layer, i);
+        qppBackend.rz(0.7 - 0.1 * i, i);
+      }
+      for (std::size_t i = 0; i < num_qubits - 1; i++)
+        qppBackend.x({i}, i + 1);
+      qppBackend.applyCustomOperation(matrix, {}, {4, 1});
+      qppBackend.h({0, 2}, 5);
+      qppBackend.swap(3, 0);
+      qppBackend.r1(0.4, {5}, 2);
+    }
+    return qppBackend.getStateVector();
+  };
+
+  qpp::ket want_state = runCircuit(0);
+  for (std::size_t k : {2, 3, 4, 5})
+    EXPECT_EQ_KETS(want_state, runCircuit(k), 1e-12);
+}
+
+// Check that remapping the most used qubits onto the low order bits of the
+// state vector while flushing the gate queue, and applying the gates on
+// those bits tile by tile, does not change the state.
+CUDAQ_TEST(QPPTester, checkQubitLayoutRemapping) {
+  class LocalitySimulator : public QppCircuitSimulator<qpp::ket> {
+  public:
+    LocalitySimulator(std::size_t l) { localityQubits = l; }
+  };
+
+  const std::size_t num_qubits = 8;
+  auto runCircuit = [&](std::size_t l) {
+    LocalitySimulator qppBackend(l);
+    qppBackend.allocateQubits(num_qubits);
+    for (std::size_t layer = 0; layer < 3; layer++) {
+      for (std::size_t i = 0; i < num_qubits; i++) {
+        qppBackend.ry(0.3 + 0.2 * i + layer, i);
+        qppBackend.rz(0.7 - 0.1 * i, i);
+      }
+      // Many gates on the high order qubits 0 to 2.
+      for (std::size_t k = 0; k < 6; k++) {
+        qppBackend.h(0);
+        qppBackend.x({0}, 1);
+        qppBackend.rx(0.4 + k, 1);
+        qppBackend.x({1}, 2);
+      }
+      qppBackend.swap(3, 0);
+      qppBackend.r1(0.4, {5}, 2);
+      // Measuring flushes the queue in the middle of the circuit.
+      if (layer == 1)
+        qppBackend.mz(7);
+    }
+    return qppBackend.getStateVector();
+  };
+
+  qpp::RandomDevices::get_instance().get_prng().seed(13);
+  qpp::ket want_state = runCircuit(0);
+  for (std::size_t l : {1, 3, 5}) {
+    qpp::RandomDevices::get_instance().get_prng().seed(13);
+    EXPECT_EQ_KETS(want_state, runCircuit(l), 1e-12);
+  }
+}
+
+// Check the single precision state vector backend against the double
+// precision one, for a deep circuit and for measurement and reset.
+CUDAQ_TEST(QPPTester, checkSinglePrecision) {
+  const std::size_t num_qubits = 10;
+  auto runCircuit = [&](auto &qppBackend) {
+    qppBackend.allocateQubits(num_qubits);
+    for (std::size_t layer = 0; layer < 20; layer++) {
+      for (std::size_t i = 0; i < num_qubits; i++) {
+        qppBackend.ry(0.3 + 0.2 * i + layer, i);
+        qppBackend.rz(0.7 - 0.1 * i, i);
+      }
+      for (std::size_t i = 0; i < num_qubits - 1; i++)
+        qppBackend.x({i}, i + 1);
+      qppBackend.swap(layer % num_qubits, num_qubits - 1);
+    }
+    return qppBackend.getStateVector();
+  };
+
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  QppCircuitSimulator<Eigen::VectorXcf> qppBackendF32;
+  EXPECT_EQ(qppBackendF32.name(), "qpp-f32");
+  qpp::ket want_state = runCircuit(qppBackend);
+  qpp::ket got_state =
+      runCircuit(qppBackendF32).template cast<std::complex<double>>();
+  EXPECT_EQ_KETS(want_state, got_state, 1e-5);
+
+  // Measurement and reset collapse and renormalize the state.
+  auto result = qppBackendF32.mz(3);
+  auto collapsed_state = qppBackendF32.getStateVector();
+  EXPECT_NEAR(collapsed_state.norm(), 1.0, 1e-5);
+  EXPECT_EQ(result, qppBackendF32.mz(3));
+  qppBackendF32.resetQubit(3);
+  EXPECT_FALSE(qppBackendF32.mz(3));
+  EXPECT_NEAR(qppBackendF32.getStateVector().norm(), 1.0, 1e-5);
+}
+
+// Check that sampling a subset of the qubits draws from the marginal
+// distribution of those qubits, in the requested qubit order.
+CUDAQ_TEST(QPPTester, checkMarginalSampling) {
+  const std::size_t num_qubits = 4;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(num_qubits);
+  // P(q0 = 1) = 0.25, P(q2 = 1) = 0.75, q1 = 1 and q3 = 0 always.
+  qppBackend.ry(M_PI / 3., 0);
+  qppBackend.x(1);
+  qppBackend.ry(2. * M_PI / 3., 2);
+  qppBackend.flushGateQueue();
+
+  const int shots = 100000;
+  auto counts = qppBackend.sample({2, 0, 1}, shots);
+  // <Z2 Z0 Z1> = -0.5 * 0.5 * -1, exact rather than estimated from shots.
+  ASSERT_TRUE(counts.expectationValue.has_value());
+  EXPECT_NEAR(counts.expectationValue.value(), 0.25, 1e-12);
+  std::map<std::string, double> want{{"001", 0.1875},
+                                     {"011", 0.0625},
+                                     {"101", 0.5625},
+                                     {"111", 0.1875}};
+  std::size_t total = 0;
+  for (auto &[bits, count] : counts.counts) {
+    ASSERT_TRUE(want.count(bits)) << bits;
+    EXPECT_NEAR(static_cast<double>(count) / shots, want[bits], 0.01);
+    total += count;
+  }
+  EXPECT_EQ(total, shots);
+
+  // The exact <Z...Z> expectation is computed for every sampling context.
+  cudaq::ExecutionContext observeCtx("observe", shots),
+      sampleCtx("sample", shots);
+  for (auto *ctx : {&observeCtx, &sampleCtx}) {
+    qppBackend.setExecutionContext(ctx);
+    auto contextCounts = qppBackend.sample({0, 2}, shots);
+    ASSERT_TRUE(contextCounts.expectationValue.has_value());
+    EXPECT_NEAR(contextCounts.expectationValue.value(), 0.5 * -0.5, 1e-12);
+  }
+}
+
+// Check the simulator-side observe against applying each Pauli term to a
+// copy of the state with qpp::apply.
+CUDAQ_TEST(QPPTester, checkObserve) {
+  const std::size_t num_qubits = 6;
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  qppBackend.allocateQubits(num_qubits);
+  for (std::size_t i = 0; i < num_qubits; i++) {
+    qppBackend.ry(0.3 + 0.2 * i, i);
+    qppBackend.rz(0.7 - 0.1 * i, i);
+  }
+  for (std::size_t i = 0; i < num_qubits - 1; i++)
+    qppBackend.x({i}, i + 1);
+  qpp::ket state = qppBackend.getStateVector();
+
+  // Exact observe tasks are handled by the simulator, shot-based ones are
+  // not.
+  cudaq::ExecutionContext exactCtx("observe");
+  qppBackend.setExecutionContext(&exactCtx);
+  EXPECT_TRUE(exactCtx.canHandleObserve);
+  cudaq::ExecutionContext shotsCtx("observe", 1000);
+  qppBackend.setExecutionContext(&shotsCtx);
+  EXPECT_FALSE(shotsCtx.canHandleObserve);
+
+  // Also act on fewer qubits than are allocated.
+  for (std::size_t nSpinQubits : {num_qubits, num_qubits - 2}) {
+    auto h = cudaq::spin_op::random(nSpinQubits, 50);
+    auto bsf = h.get_bsf();
+    auto coefficients = h.get_coefficients();
+    double want = 0.0;
+    for (std::size_t t = 0; t < bsf.size(); t++) {
+      qpp::ket tmp = state;
+      for (std::size_t q = 0; q < nSpinQubits; q++) {
+        if (bsf[t][q] && bsf[t][q + nSpinQubits])
+          tmp = qpp::apply(tmp, qpp::Gates::get_instance().Y, {q});
+        else if (bsf[t][q])
+          tmp = qpp::apply(tmp, qpp::Gates::get_instance().X, {q});
+        else if (bsf[t][q + nSpinQubits])
+          tmp = qpp::apply(tmp, qpp::Gates::get_instance().Z, {q});
+      }
+      want += coefficients[t].real() * state.dot(tmp).real();
+    }
+
+    auto got = qppBackend.observe(h);
+    ASSERT_TRUE(got.expectationValue.has_value());
+    EXPECT_NEAR(want, got.expectationValue.value(), 1e-10);
+  }
+}
+
+// Deallocating the qubits with the highest indices shrinks the state, and
+// deallocated qubits below a live one are handed out again.
+CUDAQ_TEST(QPPTester, checkDeallocationShrinksState) {
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  auto q0 = qppBackend.allocateQubit();
+  auto q1 = qppBackend.allocateQubit();
+  qppBackend.h(q0);
+  qppBackend.x({q0}, q1);
+  qpp::ket bell = qpp::ket::Zero(4);
+  bell(0) = bell(3) = M_SQRT1_2;
+
+  // An ancilla used in a loop does not grow the state.
+  for (std::size_t i = 0; i < 50; i++) {
+    auto ancilla = qppBackend.allocateQubit();
+    EXPECT_EQ(2, ancilla);
+    qppBackend.x({q0}, ancilla);
+    qppBackend.x({q1}, ancilla);
+    qppBackend.deallocate(ancilla);
+    EXPECT_EQ_KETS(bell, qppBackend.getStateVector(), 1e-12);
+  }
+
+  // Deallocate a qubit below a live one, it stays in the state until the
+  // live one is deallocated.
+  auto q2 = qppBackend.allocateQubit();
+  auto q3 = qppBackend.allocateQubit();
+  qppBackend.x(q2);
+  qppBackend.x(q3);
+  qppBackend.deallocate(q2);
+  EXPECT_EQ(16, qppBackend.getStateVector().size());
+  auto q4 = qppBackend.allocateQubit();
+  EXPECT_EQ(q2, q4);
+  EXPECT_EQ(16, qppBackend.getStateVector().size());
+  EXPECT_EQ(0, qppBackend.mz(q4));
+  EXPECT_EQ(1, qppBackend.mz(q3));
+  qppBackend.deallocate(q3);
+  EXPECT_EQ(8, qppBackend.getStateVector().size());
+  qppBackend.deallocate(q4);
+  EXPECT_EQ_KETS(bell, qppBackend.getStateVector(), 1e-12);
+
+  // Allocating several qubits at once reuses the deallocated ones too.
+  qppBackend.allocateQubits(2);
+  qppBackend.deallocate(2);
+  EXPECT_EQ(16, qppBackend.getStateVector().size());
+  auto qubits = qppBackend.allocateQubits(2);
+  EXPECT_EQ(std::vector<std::size_t>({2, 4}), qubits);
+  EXPECT_EQ(32, qppBackend.getStateVector().size());
+}
+
+// Under an execution context, deallocating a qubit the context does not read
+// traces it out right away and leaves the other qubits unchanged.
+CUDAQ_TEST(QPPTester, checkDeallocationUnderContext) {
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  auto h = cudaq::spin::z(0) * cudaq::spin::z(1);
+  cudaq::ExecutionContext ctx("observe");
+  ctx.spin = &h;
+  qppBackend.setExecutionContext(&ctx);
+  auto q0 = qppBackend.allocateQubit();
+  auto q1 = qppBackend.allocateQubit();
+  qppBackend.h(q0);
+  qppBackend.x({q0}, q1);
+  qpp::ket bell = qpp::ket::Zero(4);
+  bell(0) = bell(3) = M_SQRT1_2;
+
+  // The ancilla is entangled with the Bell pair until it is uncomputed.
+  for (std::size_t i = 0; i < 50; i++) {
+    auto ancilla = qppBackend.allocateQubit();
+    EXPECT_EQ(2, ancilla);
+    qppBackend.x({q0}, ancilla);
+    qppBackend.x({q1}, ancilla);
+    qppBackend.deallocate(ancilla);
+    EXPECT_EQ_KETS(bell, qppBackend.getStateVector(), 1e-12);
+  }
+
+  // A qubit of the spin_op is kept until the context ends.
+  qppBackend.deallocate(q1);
+  EXPECT_EQ(4, qppBackend.getStateVector().size());
+  EXPECT_NEAR(1.0, qppBackend.observe(h).expectationValue.value(), 1e-12);
+  qppBackend.resetExecutionContext();
+  EXPECT_EQ(2, qppBackend.getStateVector().size());
+  qppBackend.deallocate(q0);
+}
+
+// The default sample set only holds the qubits that are still allocated.
+CUDAQ_TEST(QPPTester, checkDefaultSampleSkipsDeallocatedQubits) {
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  auto q0 = qppBackend.allocateQubit();
+  auto q1 = qppBackend.allocateQubit();
+  auto q2 = qppBackend.allocateQubit();
+  qppBackend.x(q0);
+  qppBackend.x(q2);
+  qppBackend.deallocate(q0);
+  EXPECT_EQ("01", getSampledBitString(qppBackend, {}));
+
+  // Also for a qubit deallocated under the sample context once its result
+  // has been recorded.
+  cudaq::ExecutionContext ctx("sample", 1);
+  ctx.hasConditionalsOnMeasureResults = true;
+  qppBackend.setExecutionContext(&ctx);
+  auto ancilla = qppBackend.allocateQubit();
+  qppBackend.x({q2}, ancilla);
+  EXPECT_TRUE(qppBackend.mz(ancilla, "ancilla"));
+  qppBackend.deallocate(ancilla);
+  qppBackend.resetExecutionContext();
+  EXPECT_EQ(1, ctx.result.count("01"));
+  EXPECT_EQ(1, ctx.result.count("1", "ancilla"));
+  qppBackend.deallocate(q1);
+  qppBackend.deallocate(q2);
+}
@@ -115,6 +115,32 @@ CUDAQ_TEST(QuantinuumTester, checkObserveSync) {
   EXPECT_NEAR(result.exp_val_z(), -1.7, 1e-1);
 }
 
+CUDAQ_TEST(QuantinuumTester, checkObserveRepeatedLaunches) {
+  std::string home = std::getenv("HOME");
+  std::string fileName = home + "/FakeCppQuantinuum.config";
+  auto backendString =
+      fmt::format(fmt::runtime(backendStringTemplate), mockPort, fileName);
+
+  auto &platform = cudaq::get_platform();
+  platform.setTargetBackend(backendString);
+
+  auto [kernel, theta] = cudaq::make_kernel<double>();
+  auto qubit = kernel.qalloc(2);
+  kernel.x(qubit[0]);
+  kernel.ry(theta, qubit[1]);
+  kernel.x<cudaq::ctrl>(qubit[1], qubit[0]);
+
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  // Later launches reuse the lowered kernel, but must still synthesize the
+  // new argument.
+  EXPECT_NEAR(cudaq::observe(kernel, h, .59).exp_val_z(), -1.7, 1e-1);
+  EXPECT_NEAR(cudaq::observe(kernel, h, 0.).exp_val_z(), -.436, 1e-1);
+  EXPECT_NEAR(cudaq::observe(kernel, h, .59).exp_val_z(), -1.7, 1e-1);
+}
+
 CUDAQ_TEST(QuantinuumTester, checkObserveAsync) {
   std::string home = std::getenv("HOME");
   std::string fileName = home + "/FakeCppQuantinuum.config";
@@ -0,0 +1,85 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#include <cudaq.h>
+#include <cudaq/algorithm.h>
+#include <cudaq/platform/QuantumExecutionQueue.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+/// This benchmark measures the throughput of many small sampling tasks
+/// submitted to a QuantumExecutionQueue, for an increasing number of worker
+/// threads. Every task samples a small layered circuit on the default
+/// platform, with the worker's thread-local simulator.
+///
+/// Usage: benchmark_async_throughput [nTasks] [nQubits] [shots] [maxThreads]
+
+namespace {
+
+struct layers {
+  void operator()(int nQubits) __qpu__ {
+    cudaq::qreg q(nQubits);
+    for (int layer = 0; layer < 10; layer++) {
+      for (int i = 0; i < nQubits; i++)
+        ry(0.1 * (layer + 1) * (i + 1), q[i]);
+      for (int i = 0; i < nQubits - 1; i++)
+        x<cudaq::ctrl>(q[i], q[i + 1]);
+    }
+    mz(q);
+  }
+};
+
+/// @brief Run nTasks sampling tasks on a queue with the given number of
+/// threads, return the elapsed seconds.
+double run(std::size_t numThreads, std::size_t nTasks, int nQubits,
+           int shots) {
+  auto &platform = cudaq::get_platform();
+  std::vector<std::future<cudaq::sample_result>> results;
+  auto start = std::chrono::high_resolution_clock::now();
+  {
+    cudaq::QuantumExecutionQueue queue(numThreads);
+    for (std::size_t i = 0; i < nTasks; i++) {
+      auto promise = std::make_shared<std::promise<cudaq::sample_result>>();
+      results.emplace_back(promise->get_future());
+      cudaq::QuantumTask task = [&, promise]() {
+        promise->set_value(
+            cudaq::details::runSampling([&]() mutable { layers{}(nQubits); },
+                                        platform, "layers", shots)
+                .value());
+      };
+      queue.enqueue(task);
+    }
+    for (auto &result : results)
+      result.wait();
+  }
+  auto stop = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nTasks = argc > 1 ? std::stoul(argv[1]) : 2000;
+  int nQubits = argc > 2 ? std::stoi(argv[2]) : 8;
+  int shots = argc > 3 ? std::stoi(argv[3]) : 100;
+  std::size_t maxThreads = argc > 4 ? std::stoul(argv[4])
+                                    : std::thread::hardware_concurrency();
+
+  printf("%8s %8s %12s %14s %9s\n", "threads", "tasks", "time(s)", "tasks/s",
+         "speedup");
+  double reference = 0.0;
+  for (std::size_t n = 1; n <= std::max<std::size_t>(maxThreads, 1); n *= 2) {
+    auto time = run(n, nTasks, nQubits, shots);
+    if (n == 1)
+      reference = time;
+    printf("%8lu %8lu %12.4f %14.1f %8.2fx\n", n, nTasks, time, nTasks / time,
+           reference / time);
+  }
+  return 0;
+}
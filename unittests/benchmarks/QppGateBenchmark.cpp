@@ -0,0 +1,149 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+#undef __NVQIR_QPP_TOGGLE_CREATE
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+/// This benchmark compares the in-place state vector kernels used by the
+/// QppCircuitSimulator against the qpp::applyCTRL path (one new ket per gate)
+/// on GHZ, QFT, random and layered variational circuits, with and without
+/// gate fusion. The maximum fused gate size is picked up from the
+/// CUDAQ_FUSION_MAX_QUBITS environment variable.
+///
+/// Usage: benchmark_qpp_gates [nQubitsMin] [nQubitsMax] [nQubitsMaxReference]
+///
+/// The qpp::applyCTRL reference is skipped above nQubitsMaxReference qubits,
+/// since it is orders of magnitude slower than the in-place kernels.
+
+namespace {
+
+/// @brief The QppApplyCTRLSimulator applies every gate through
+/// qpp::applyCTRL, the reference for the in-place kernels.
+class QppApplyCTRLSimulator : public nvqir::QppCircuitSimulator<qpp::ket> {
+protected:
+  void applyGate(const GateApplicationTask &task) override {
+    auto matrix = toQppMatrix(task.matrix, task.targets.size());
+    state = qpp::applyCTRL(state, matrix, task.controls, task.targets);
+  }
+
+public:
+  QppApplyCTRLSimulator() { maxFusedQubits = 0; }
+};
+
+/// @brief The QppUnfusedSimulator applies every gate with the in-place
+/// kernels, one at a time.
+class QppUnfusedSimulator : public nvqir::QppCircuitSimulator<qpp::ket> {
+public:
+  QppUnfusedSimulator() { maxFusedQubits = 0; }
+};
+
+/// @brief A benchmark circuit is a functor that applies gates to the
+/// given simulator, on the given number of qubits.
+using Circuit = std::function<void(nvqir::CircuitSimulator &, std::size_t)>;
+
+void ghz(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  sim.h(0);
+  for (std::size_t i = 0; i < nQubits - 1; i++)
+    sim.x({i}, i + 1);
+}
+
+void qft(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  for (std::size_t i = 0; i < nQubits; i++) {
+    sim.h(i);
+    for (std::size_t j = i + 1; j < nQubits; j++)
+      sim.r1(M_PI / std::pow(2.0, j - i), {j}, i);
+  }
+  for (std::size_t i = 0; i < nQubits / 2; i++)
+    sim.swap(i, nQubits - i - 1);
+}
+
+void randomCircuit(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+  std::uniform_int_distribution<std::size_t> qubit(0, nQubits - 1);
+  for (std::size_t layer = 0; layer < 10; layer++) {
+    for (std::size_t i = 0; i < nQubits; i++) {
+      sim.rx(angle(gen), i);
+      sim.rz(angle(gen), i);
+    }
+    for (std::size_t i = 0; i < nQubits; i++) {
+      auto t = qubit(gen);
+      if (t != i)
+        sim.x({i}, t);
+    }
+  }
+}
+
+void ansatz(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+  for (std::size_t layer = 0; layer < 10; layer++) {
+    for (std::size_t i = 0; i < nQubits; i++) {
+      sim.ry(angle(gen), i);
+      sim.rz(angle(gen), i);
+    }
+    for (std::size_t i = 0; i < nQubits - 1; i++)
+      sim.x({i}, i + 1);
+  }
+}
+
+/// @brief Run the circuit on the simulator, return the elapsed seconds and
+/// the final state.
+template <typename Simulator>
+std::pair<double, qpp::ket> run(const Circuit &circuit, std::size_t nQubits) {
+  Simulator sim;
+  sim.allocateQubits(nQubits);
+  auto start = std::chrono::high_resolution_clock::now();
+  circuit(sim, nQubits);
+  auto state = sim.getStateVector();
+  auto stop = std::chrono::high_resolution_clock::now();
+  return {std::chrono::duration<double>(stop - start).count(), state};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nMin = argc > 1 ? std::stoul(argv[1]) : 16;
+  std::size_t nMax = argc > 2 ? std::stoul(argv[2]) : 26;
+  std::size_t nMaxReference = argc > 3 ? std::stoul(argv[3]) : 18;
+  std::vector<std::pair<std::string, Circuit>> circuits{
+      {"ghz", ghz},
+      {"qft", qft},
+      {"random", randomCircuit},
+      {"ansatz", ansatz}};
+
+  printf("%-8s %8s %14s %14s %9s %12s %9s %12s\n", "circuit", "qubits",
+         "applyCTRL(s)", "in-place(s)", "speedup", "fused(s)", "speedup",
+         "max |diff|");
+  for (auto &[name, circuit] : circuits) {
+    for (std::size_t n = nMin; n <= nMax; n += 2) {
+      auto [time, state] = run<QppUnfusedSimulator>(circuit, n);
+      auto [fusedTime, fusedState] =
+          run<nvqir::QppCircuitSimulator<qpp::ket>>(circuit, n);
+      double maxDiff = (fusedState - state).cwiseAbs().maxCoeff();
+      if (n > nMaxReference) {
+        printf("%-8s %8lu %14s %14.4f %9s %12.4f %8.2fx %12.3e\n",
+               name.c_str(), n, "-", time, "-", fusedTime, time / fusedTime,
+               maxDiff);
+        continue;
+      }
+      auto [refTime, refState] = run<QppApplyCTRLSimulator>(circuit, n);
+      maxDiff = std::max(maxDiff, (refState - state).cwiseAbs().maxCoeff());
+      printf("%-8s %8lu %14.4f %14.4f %8.2fx %12.4f %8.2fx %12.3e\n",
+             name.c_str(), n, refTime, time, refTime / time, fusedTime,
+             time / fusedTime, maxDiff);
+    }
+  }
+  return 0;
+}
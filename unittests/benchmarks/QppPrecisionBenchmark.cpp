@@ -0,0 +1,71 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+#undef __NVQIR_QPP_TOGGLE_CREATE
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+/// This benchmark compares the throughput and accuracy of the single
+/// precision (qpp-f32) and double precision (qpp) state vector simulators
+/// on a layered variational circuit.
+///
+/// Usage: benchmark_qpp_precision [nQubitsMin] [nQubitsMax] [nLayers]
+
+namespace {
+
+void ansatz(nvqir::CircuitSimulator &sim, std::size_t nQubits,
+            std::size_t nLayers) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+  for (std::size_t layer = 0; layer < nLayers; layer++) {
+    for (std::size_t i = 0; i < nQubits; i++) {
+      sim.ry(angle(gen), i);
+      sim.rz(angle(gen), i);
+    }
+    for (std::size_t i = 0; i < nQubits - 1; i++)
+      sim.x({i}, i + 1);
+  }
+}
+
+/// @brief Run the circuit on the given state type, return the elapsed
+/// seconds and the final state in double precision.
+template <typename StateType>
+std::pair<double, qpp::ket> run(std::size_t nQubits, std::size_t nLayers) {
+  nvqir::QppCircuitSimulator<StateType> sim;
+  sim.allocateQubits(nQubits);
+  auto start = std::chrono::high_resolution_clock::now();
+  ansatz(sim, nQubits, nLayers);
+  auto state = sim.getStateVector();
+  auto stop = std::chrono::high_resolution_clock::now();
+  return {std::chrono::duration<double>(stop - start).count(),
+          state.template cast<std::complex<double>>()};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nMin = argc > 1 ? std::stoul(argv[1]) : 16;
+  std::size_t nMax = argc > 2 ? std::stoul(argv[2]) : 26;
+  std::size_t nLayers = argc > 3 ? std::stoul(argv[3]) : 10;
+
+  printf("%8s %12s %12s %9s %12s %12s\n", "qubits", "f64(s)", "f32(s)",
+         "speedup", "max |diff|", "fidelity");
+  for (std::size_t n = nMin; n <= nMax; n += 2) {
+    auto [time, state] = run<qpp::ket>(n, nLayers);
+    auto [timeF32, stateF32] = run<Eigen::VectorXcf>(n, nLayers);
+    double maxDiff = (state - stateF32).cwiseAbs().maxCoeff();
+    double fidelity = std::norm(state.dot(stateF32));
+    printf("%8lu %12.4f %12.4f %8.2fx %12.3e %12.9f\n", n, time, timeF32,
+           time / timeF32, maxDiff, fidelity);
+  }
+  return 0;
+}
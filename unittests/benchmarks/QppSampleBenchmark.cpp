@@ -0,0 +1,79 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+#undef __NVQIR_QPP_TOGGLE_CREATE
+
+#include <chrono>
+#include <cstdio>
+
+/// This benchmark compares the latency of QppCircuitSimulator::sample, which
+/// builds the marginal probability table of the measured qubits and draws all
+/// shots from it, against qpp::sample followed by bitstring formatting.
+///
+/// Usage: benchmark_qpp_sample [nQubitsMin] [nQubitsMax] [shots]
+
+namespace {
+
+/// @brief Expose the state and the sampler of the QppCircuitSimulator.
+class QppSampleSimulator : public nvqir::QppCircuitSimulator<qpp::ket> {
+public:
+  /// @brief The reference sampler, qpp::sample and a stringstream per
+  /// bitstring.
+  cudaq::ExecutionResult qppSample(const std::vector<std::size_t> &qubits,
+                                   const int shots) {
+    auto sampleResult = qpp::sample(shots, state, qubits, 2);
+    std::stringstream bitstring;
+    cudaq::ExecutionResult counts;
+    for (auto [result, count] : sampleResult) {
+      for (const auto &bit : result)
+        bitstring << bit;
+      counts.appendResult(bitstring.str(), count);
+      bitstring.str("");
+      bitstring.clear();
+    }
+    return counts;
+  }
+};
+
+template <typename Functor>
+double time(Functor &&functor) {
+  auto start = std::chrono::high_resolution_clock::now();
+  functor();
+  auto stop = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nMin = argc > 1 ? std::stoul(argv[1]) : 16;
+  std::size_t nMax = argc > 2 ? std::stoul(argv[2]) : 24;
+  int shots = argc > 3 ? std::stoi(argv[3]) : 100000;
+
+  printf("%8s %10s %14s %14s %9s\n", "qubits", "measured", "qpp::sample(s)",
+         "sample(s)", "speedup");
+  for (std::size_t n = nMin; n <= nMax; n += 2) {
+    QppSampleSimulator sim;
+    sim.allocateQubits(n);
+    for (std::size_t i = 0; i < n; i++)
+      sim.ry(0.1 + 0.2 * i, i);
+    sim.flushGateQueue();
+
+    std::vector<std::size_t> all(n), half(n / 2);
+    std::iota(all.begin(), all.end(), 0);
+    std::iota(half.begin(), half.end(), 0);
+    for (auto *qubits : {&half, &all}) {
+      double refTime = time([&]() { sim.qppSample(*qubits, shots); });
+      double newTime = time([&]() { sim.sample(*qubits, shots); });
+      printf("%8lu %10lu %14.4f %14.4f %8.2fx\n", n, qubits->size(), refTime,
+             newTime, refTime / newTime);
+    }
+  }
+  return 0;
+}
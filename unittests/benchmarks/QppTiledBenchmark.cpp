@@ -0,0 +1,121 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+
+#define __NVQIR_QPP_TOGGLE_CREATE
+#include "QppCircuitSimulator.cpp"
+#undef __NVQIR_QPP_TOGGLE_CREATE
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+/// This benchmark compares the state vector simulator applying the queued
+/// gates one sweep over the state at a time against the cache-blocked
+/// execution, where the most used qubits are remapped onto the low order
+/// bits and runs of gates on those bits are applied tile by tile, on QFT and
+/// random circuits. The effective bandwidth is the memory traffic one read
+/// and one write of the state per gate would take, divided by the run time.
+///
+/// Usage: benchmark_qpp_tiled [nQubitsMin] [nQubitsMax] [tileQubits]
+
+namespace {
+
+/// @brief The QppTiledSimulator counts the gates it applies, with the given
+/// tile size (0 disables the cache-blocked execution).
+class QppTiledSimulator : public nvqir::QppCircuitSimulator<qpp::ket> {
+protected:
+  void flushGateQueueImpl() override {
+    nGates += gateQueue.size();
+    nvqir::QppCircuitSimulator<qpp::ket>::flushGateQueueImpl();
+  }
+
+public:
+  std::size_t nGates = 0;
+  QppTiledSimulator(std::size_t tileQubits) { localityQubits = tileQubits; }
+};
+
+/// @brief A benchmark circuit is a functor that applies gates to the
+/// given simulator, on the given number of qubits.
+using Circuit = std::function<void(nvqir::CircuitSimulator &, std::size_t)>;
+
+void qft(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  for (std::size_t i = 0; i < nQubits; i++) {
+    sim.h(i);
+    for (std::size_t j = i + 1; j < nQubits; j++)
+      sim.r1(M_PI / std::pow(2.0, j - i), {j}, i);
+  }
+  for (std::size_t i = 0; i < nQubits / 2; i++)
+    sim.swap(i, nQubits - i - 1);
+}
+
+void randomCircuit(nvqir::CircuitSimulator &sim, std::size_t nQubits) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+  std::uniform_int_distribution<std::size_t> qubit(0, nQubits - 1);
+  for (std::size_t layer = 0; layer < 10; layer++) {
+    for (std::size_t i = 0; i < nQubits; i++) {
+      sim.rx(angle(gen), i);
+      sim.rz(angle(gen), i);
+    }
+    for (std::size_t i = 0; i < nQubits; i++) {
+      auto t = qubit(gen);
+      if (t != i)
+        sim.x({i}, t);
+    }
+  }
+}
+
+struct RunResult {
+  double time;
+  std::size_t nGates;
+  qpp::ket state;
+};
+
+/// @brief Run the circuit with the given tile size, return the elapsed
+/// seconds, the number of gates and the final state.
+RunResult run(const Circuit &circuit, std::size_t nQubits,
+              std::size_t tileQubits) {
+  QppTiledSimulator sim(tileQubits);
+  sim.allocateQubits(nQubits);
+  auto start = std::chrono::high_resolution_clock::now();
+  circuit(sim, nQubits);
+  sim.flushGateQueue();
+  auto stop = std::chrono::high_resolution_clock::now();
+  return {std::chrono::duration<double>(stop - start).count(), sim.nGates,
+          sim.getStateVector()};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t nMin = argc > 1 ? std::stoul(argv[1]) : 24;
+  std::size_t nMax = argc > 2 ? std::stoul(argv[2]) : 28;
+  std::size_t tileQubits =
+      argc > 3 ? std::stoul(argv[3]) : nvqir::DefaultLocalityQubits;
+  std::vector<std::pair<std::string, Circuit>> circuits{
+      {"qft", qft}, {"random", randomCircuit}};
+
+  printf("%-8s %8s %8s %12s %12s %12s %12s %9s %12s\n", "circuit", "qubits",
+         "gates", "sweep(s)", "sweep(GB/s)", "tiled(s)", "tiled(GB/s)",
+         "speedup", "max |diff|");
+  for (auto &[name, circuit] : circuits) {
+    for (std::size_t n = nMin; n <= nMax; n += 2) {
+      auto sweep = run(circuit, n, 0);
+      auto tiled = run(circuit, n, tileQubits);
+      const double stateBytes = sizeof(std::complex<double>) * (1ULL << n);
+      const double traffic = 2. * stateBytes * sweep.nGates / 1e9;
+      double maxDiff = (tiled.state - sweep.state).cwiseAbs().maxCoeff();
+      printf("%-8s %8lu %8lu %12.4f %12.2f %12.4f %12.2f %8.2fx %12.3e\n",
+             name.c_str(), n, sweep.nGates, sweep.time, traffic / sweep.time,
+             tiled.time, traffic / tiled.time, sweep.time / tiled.time,
+             maxDiff);
+    }
+  }
+  return 0;
+}
@@ -8,6 +8,7 @@
 
 #include "CUDAQTestUtils.h"
 #include <cudaq/algorithm.h>
+#include <cudaq/platform/QuantumExecutionQueue.h>
 
 #ifndef CUDAQ_BACKEND_DM
 
@@ -70,4 +71,65 @@ CUDAQ_TEST(AsyncTester, checkSampleAsync) {
   cc2.get().dump();
   cc3.get().dump();
 }
+
+CUDAQ_TEST(AsyncTester, checkExecutionQueueThreadPool) {
+  struct ghz {
+    auto operator()(int NQubits) __qpu__ {
+      cudaq::qreg q(NQubits);
+      h(q[0]);
+      for (int i = 0; i < NQubits - 1; i++) {
+        x<cudaq::ctrl>(q[i], q[i + 1]);
+      }
+      mz(q);
+    }
+  };
+
+  // Every task waits for all others to start, so they must run on
+  // different workers, and then samples through the same platform
+  // concurrently.
+  constexpr std::size_t numTasks = 4;
+  auto &platform = cudaq::get_platform();
+  std::mutex lock;
+  std::condition_variable cv;
+  std::size_t started = 0;
+  std::vector<std::future<cudaq::sample_result>> results;
+  {
+    cudaq::QuantumExecutionQueue queue(numTasks);
+    EXPECT_EQ(numTasks, queue.getNumThreads());
+    for (std::size_t i = 0; i < numTasks; i++) {
+      auto promise = std::make_shared<std::promise<cudaq::sample_result>>();
+      results.emplace_back(promise->get_future());
+      cudaq::QuantumTask task = [&, promise]() {
+        {
+          std::unique_lock<std::mutex> l(lock);
+          started++;
+          cv.notify_all();
+          cv.wait(l, [&] { return started == numTasks; });
+        }
+        promise->set_value(
+            cudaq::details::runSampling([]() mutable { ghz{}(5); }, platform,
+                                        "ghz", 100)
+                .value());
+      };
+      queue.enqueue(task);
+    }
+
+    for (auto &result : results) {
+      auto counts = result.get();
+      EXPECT_EQ(2, counts.size());
+      EXPECT_EQ(100, counts.count("00000") + counts.count("11111"));
+    }
+  }
+
+  // Tasks enqueued from within a task run as well.
+  cudaq::QuantumExecutionQueue queue(2);
+  std::promise<int> outer;
+  auto f = outer.get_future();
+  cudaq::QuantumTask task = [&]() {
+    cudaq::QuantumTask inner = [&]() { outer.set_value(42); };
+    queue.enqueue(inner);
+  };
+  queue.enqueue(task);
+  EXPECT_EQ(42, f.get());
+}
 #endif
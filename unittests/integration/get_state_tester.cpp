@@ -9,8 +9,10 @@
 #include "CUDAQTestUtils.h"
 #include <cudaq/algorithm.h>
 #include <cudaq/optimizers.h>
+#include <filesystem>
 #include <fmt/core.h>
 #include <numeric>
+#include <unistd.h>
 
 using namespace cudaq;
 
@@ -68,3 +70,78 @@ CUDAQ_TEST(GetStateTester, checkSimple) {
 
   EXPECT_NEAR(opt_val, 0.0, 1e-3);
 }
+
+CUDAQ_TEST(GetStateTester, checkSaveAndLoad) {
+  auto kernel = []() __qpu__ {
+    cudaq::qreg q(3);
+    h(q[0]);
+    ry(0.7, q[1]);
+    x<cudaq::ctrl>(q[0], q[2]);
+  };
+
+  auto state = cudaq::get_state(kernel);
+  auto copy = state;
+  EXPECT_EQ(state.get_data(), copy.get_data());
+
+  auto fileName = std::filesystem::temp_directory_path() /
+                  fmt::format("get_state_tester_{}.bin", ::getpid());
+  state.save(fileName.string());
+  auto loaded = cudaq::state::load(fileName.string());
+  std::filesystem::remove(fileName);
+
+  EXPECT_EQ(state.get_shape(), loaded.get_shape());
+  std::size_t size = 1;
+  for (auto extent : state.get_shape())
+    size *= extent;
+  EXPECT_EQ(8, state.get_shape()[0]);
+  for (std::size_t i = 0; i < size; i++)
+    EXPECT_EQ(state.get_data()[i], loaded.get_data()[i]);
+  EXPECT_NEAR(state.overlap(loaded), 1.0, 1e-12);
+}
+
+CUDAQ_TEST(GetStateTester, checkAmplitudesAndProbabilities) {
+  auto kernel = [](double theta) __qpu__ {
+    cudaq::qreg q(3);
+    h(q[0]);
+    x<cudaq::ctrl>(q[0], q[1]);
+    ry(theta, q[2]);
+  };
+
+  const double theta = 0.7;
+  const double c = std::cos(theta / 2), s = std::sin(theta / 2);
+#ifndef CUDAQ_BACKEND_DM
+  auto amplitudes =
+      cudaq::get_amplitudes(kernel, {"000", "111", "010"}, theta);
+  EXPECT_EQ(3, amplitudes.size());
+  EXPECT_NEAR(c / std::sqrt(2.), amplitudes[0].real(), 1e-12);
+  EXPECT_NEAR(s / std::sqrt(2.), amplitudes[1].real(), 1e-12);
+  EXPECT_NEAR(0.0, std::abs(amplitudes[2]), 1e-12);
+#endif
+
+  auto marginal = cudaq::get_probabilities(kernel, {2}, theta);
+  EXPECT_EQ(2, marginal.size());
+  EXPECT_NEAR(c * c, marginal[0], 1e-12);
+  EXPECT_NEAR(s * s, marginal[1], 1e-12);
+
+  // The first qubit is the most significant bit of the outcome.
+  auto bell = cudaq::get_probabilities(kernel, {2, 0}, theta);
+  EXPECT_EQ(4, bell.size());
+  EXPECT_NEAR(c * c / 2, bell[0], 1e-12);
+  EXPECT_NEAR(c * c / 2, bell[1], 1e-12);
+  EXPECT_NEAR(s * s / 2, bell[2], 1e-12);
+  EXPECT_NEAR(s * s / 2, bell[3], 1e-12);
+
+  auto state = cudaq::get_state(kernel, theta);
+  auto probabilities = cudaq::get_probabilities(kernel, {}, theta);
+  EXPECT_EQ(8, probabilities.size());
+  for (std::size_t i = 0; i < probabilities.size(); i++) {
+#ifdef CUDAQ_BACKEND_DM
+    EXPECT_NEAR(state(i, i).real(), probabilities[i], 1e-12);
+#else
+    EXPECT_NEAR(std::norm(state[i]), probabilities[i], 1e-12);
+#endif
+  }
+
+  EXPECT_ANY_THROW(cudaq::get_amplitudes(kernel, {"01"}, theta));
+  EXPECT_NEAR(c * c, cudaq::get_probabilities(kernel, {2}, theta)[0], 1e-12);
+}
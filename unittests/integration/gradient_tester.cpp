@@ -8,7 +8,9 @@
 
 #include "CUDAQTestUtils.h"
 #include <cudaq/algorithm.h>
+#include <cudaq/algorithms/gradients/adjoint.h>
 #include <cudaq/algorithms/gradients/central_difference.h>
+#include <cudaq/algorithms/gradients/parameter_shift.h>
 #include <cudaq/optimizers.h>
 
 #ifndef CUDAQ_BACKEND_DM
@@ -78,4 +80,102 @@ CUDAQ_TEST(GradientTester, checkSimple) {
   EXPECT_NEAR(-2.0453, opt_val, 1e-2);
 }
 
+struct ry_ansatz {
+  void operator()(std::vector<double> x) __qpu__ {
+    cudaq::qreg q(x.size());
+    for (std::size_t i = 0; i < x.size(); i++)
+      ry(x[i], q[i]);
+  }
+};
+
+CUDAQ_TEST(GradientTester, checkManyParameters) {
+  using namespace cudaq::spin;
+
+  // <Z_i> = cos(x_i), the shifted evaluations of all the parameters are
+  // dispatched together.
+  constexpr std::size_t nQubits = 8;
+  cudaq::spin_op h = z(0);
+  for (std::size_t i = 1; i < nQubits; i++)
+    h += (i + 1.) * z(i);
+
+  std::vector<double> x(nQubits), dx(nQubits), centralDx(nQubits);
+  for (std::size_t i = 0; i < nQubits; i++)
+    x[i] = -1.2 + 0.3 * i;
+
+  cudaq::gradients::parameter_shift gradient(ry_ansatz{});
+  gradient.compute(x, dx, h, 0.);
+  cudaq::gradients::central_difference central(ry_ansatz{});
+  central.step = 1e-2;
+  central.compute(x, centralDx, h, 0.);
+  for (std::size_t i = 0; i < nQubits; i++) {
+    EXPECT_NEAR(-(i + 1.) * std::sin(x[i]), dx[i], 1e-6);
+    EXPECT_NEAR(dx[i], centralDx[i], 1e-3);
+  }
+}
+
+struct entangling_ansatz {
+  void operator()(std::vector<double> theta) __qpu__ {
+    cudaq::qreg q(3);
+    h(q[0]);
+    rx(theta[0], q[1]);
+    ry<cudaq::ctrl>(2. * theta[1], q[0], q[2]);
+    x<cudaq::ctrl>(q[2], q[1]);
+    rz(theta[0] - theta[2], q[1]);
+    r1<cudaq::ctrl>(theta[2], q[1], q[0]);
+    ry(-theta[1], q[0]);
+    u3(theta[1], theta[0], -theta[2], q[2]);
+    u2<cudaq::ctrl>(theta[2], 0.5 * theta[0], q[0], q[1]);
+    u2(-theta[1], theta[2], q[0]);
+  }
+};
+
+CUDAQ_TEST(GradientTester, checkAdjoint) {
+  using namespace cudaq::spin;
+
+  cudaq::spin_op h = 0.5 * x(0) * z(1) - 1.5 * y(1) * y(2) + z(0) * z(2) +
+                     2. * x(2) - 0.25;
+  std::vector<double> x{0.3, -1.1, 0.7}, dx(3);
+
+  cudaq::gradients::adjoint gradient(entangling_ansatz{});
+  auto value = gradient.compute_value_and_gradient(x, dx, h);
+  EXPECT_NEAR(cudaq::observe(entangling_ansatz{}, h, x), value, 1e-6);
+
+  // The gate parameters are linear in x, ry(2 x_1) is not a parameter
+  // shift rule for x_1, compare to central differences.
+  cudaq::gradients::central_difference central(entangling_ansatz{});
+  central.step = 1e-2;
+  std::vector<double> centralDx(3);
+  central.compute(x, centralDx, h, value);
+  for (std::size_t i = 0; i < x.size(); i++)
+    EXPECT_NEAR(centralDx[i], dx[i], 1e-3);
+}
+
+struct nonlinear_ansatz {
+  void operator()(std::vector<double> theta) __qpu__ {
+    cudaq::qreg q(2);
+    rx(theta[0] * theta[0] * theta[0], q[0]);
+    ry(theta[0] * theta[1], q[1]);
+    x<cudaq::ctrl>(q[0], q[1]);
+  }
+};
+
+CUDAQ_TEST(GradientTester, checkAdjointNonlinearAngles) {
+  using namespace cudaq::spin;
+
+  // With a = x_0^3 and b = x_0 x_1, <H> = cos(a) - 0.5 cos(a) cos(b).
+  cudaq::spin_op h = z(0) - 0.5 * z(1);
+  std::vector<double> x{0.8, -0.6}, dx(2);
+  const double a = x[0] * x[0] * x[0], b = x[0] * x[1];
+  const double dEda = -std::sin(a) * (1. - 0.5 * std::cos(b));
+  const double dEdb = 0.5 * std::cos(a) * std::sin(b);
+
+  // The derivative of a is a central difference, off by step^2, the one of
+  // the bilinear b is exact.
+  cudaq::gradients::adjoint gradient(nonlinear_ansatz{});
+  auto value = gradient.compute_value_and_gradient(x, dx, h);
+  EXPECT_NEAR(std::cos(a) - 0.5 * std::cos(a) * std::cos(b), value, 1e-6);
+  EXPECT_NEAR(dEda * 3. * x[0] * x[0] + dEdb * x[1], dx[0], 1e-5);
+  EXPECT_NEAR(dEdb * x[0], dx[1], 1e-6);
+}
+
 #endif
@@ -10,7 +10,7 @@
 #include <cudaq/algorithm.h>
 #include <stdio.h>
 
-#ifdef CUDAQ_BACKEND_DM
+#if defined(CUDAQ_BACKEND_DM) || defined(CUDAQ_BACKEND_TRAJECTORY)
 struct xOp {
   void operator()() __qpu__ {
     cudaq::qubit q;
@@ -78,6 +78,7 @@ CUDAQ_TEST(NoiseTest, checkAmplitudeDamping) {
 
   EXPECT_NEAR(counts.probability("0"), .25, .1);
   EXPECT_NEAR(counts.probability("1"), .75, .1);
+  cudaq::unset_noise();
 }
 
 CUDAQ_TEST(NoiseTest, checkCNOT) {
@@ -154,6 +155,7 @@ CUDAQ_TEST(NoiseTest, checkCNOT) {
   auto counts = cudaq::sample(bell{});
   counts.dump();
   EXPECT_TRUE(counts.size() > 2);
+  cudaq::unset_noise();
 }
 
 CUDAQ_TEST(NoiseTest, checkExceptions) {
@@ -173,6 +175,7 @@ CUDAQ_TEST(NoiseTest, checkDepolType) {
   auto counts = cudaq::sample(xOp{});
   counts.dump();
   EXPECT_EQ(2, counts.size());
+  cudaq::unset_noise();
 }
 
 CUDAQ_TEST(NoiseTest, checkAmpDampType) {
@@ -185,6 +188,7 @@ CUDAQ_TEST(NoiseTest, checkAmpDampType) {
   EXPECT_EQ(2, counts.size());
   EXPECT_NEAR(counts.probability("0"), .25, .1);
   EXPECT_NEAR(counts.probability("1"), .75, .1);
+  cudaq::unset_noise();
 }
 
 CUDAQ_TEST(NoiseTest, checkBitFlipType) {
@@ -197,5 +201,40 @@ CUDAQ_TEST(NoiseTest, checkBitFlipType) {
   EXPECT_EQ(2, counts.size());
   EXPECT_NEAR(counts.probability("0"), .1, .1);
   EXPECT_NEAR(counts.probability("1"), .9, .1);
+  cudaq::unset_noise();
 }
+
+#ifdef CUDAQ_BACKEND_DM
+CUDAQ_TEST(NoiseTest, checkDensityMatrix) {
+  cudaq::amplitude_damping_channel ad(.25);
+  cudaq::noise_model noise;
+  noise.add_channel<cudaq::types::x>({0}, ad);
+  cudaq::set_noise(noise);
+
+  // Damping after x(q) leaves q in diag(.25, .75)
+  auto state = cudaq::get_state(xOp{});
+  EXPECT_NEAR(state(0, 0).real(), .25, 1e-9);
+  EXPECT_NEAR(state(1, 1).real(), .75, 1e-9);
+
+  // Adding a channel updates the noise applied to later kernels. Flip r
+  // with probability .1 after the controlled x.
+  auto tenth = std::sqrt(.1), rest = std::sqrt(.9);
+  cudaq::kraus_channel flipTarget(
+      {rest, 0., 0., 0., 0., rest, 0., 0., 0., 0., rest, 0., 0., 0., 0., rest},
+      {0., tenth, 0., 0., tenth, 0., 0., 0., 0., 0., 0., tenth, 0., 0., tenth,
+       0.});
+  noise.add_channel<cudaq::types::x>({0, 1}, flipTarget);
+  auto kernel = []() __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    x<cudaq::ctrl>(q, r);
+  };
+  state = cudaq::get_state(kernel);
+  std::vector<double> expected{.225, .025, .075, .675};
+  for (std::size_t i = 0; i < 4; i++)
+    for (std::size_t j = 0; j < 4; j++)
+      EXPECT_NEAR(std::abs(state(i, j)), i == j ? expected[i] : 0., 1e-9);
+  cudaq::unset_noise();
+}
+#endif
 #endif
@@ -62,3 +62,63 @@ CUDAQ_TEST(ObserveResult, checkSimple) {
   EXPECT_TRUE(x0x1Counts.size() == 4);
   platform.clear_shots();
 }
+
+CUDAQ_TEST(ObserveResult, checkQubitWiseCommutingGroups) {
+
+  using namespace cudaq::spin;
+  // The Z terms share one measurement circuit, the X terms another.
+  cudaq::spin_op h = 1.5 + z(0) + 2. * z(1) - 3. * z(0) * z(1) +
+                     0.5 * x(0) * x(1) + 0.25 * x(1);
+
+  auto ansatz = []() __qpu__ {
+    cudaq::qubit q, r;
+    x(r);
+  };
+
+  auto result = cudaq::observe(1000, ansatz, h);
+  EXPECT_NEAR(result.exp_val_z(), 1.5 + 1. - 2. + 3., 1e-1);
+  EXPECT_NEAR(result.exp_val_z(z(0) * i(1)), 1., 1e-12);
+  EXPECT_NEAR(result.exp_val_z(z(1)), -1., 1e-12);
+  EXPECT_NEAR(result.exp_val_z(z(0) * z(1)), -1., 1e-12);
+
+  // Every term gets the marginal counts on its own qubits.
+  auto z1Counts = result.counts(z(1));
+  EXPECT_EQ(1, z1Counts.size());
+  EXPECT_EQ(1000, z1Counts.count("1"));
+  auto zzCounts = result.counts(z(0) * z(1));
+  EXPECT_EQ(1, zzCounts.size());
+  EXPECT_EQ(1000, zzCounts.count("01"));
+  EXPECT_EQ(4, result.counts(x(0) * x(1)).size());
+  EXPECT_EQ(2, result.counts(x(1)).size());
+}
+
+CUDAQ_TEST(ObserveResult, checkObserveBatch) {
+
+  using namespace cudaq::spin;
+  cudaq::spin_op H = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1) + 0.5 * z(1) * x(2);
+
+  // The circuit structure depends on the parameters, the invocations with
+  // the same structure are simulated together.
+  auto ansatz = [](std::vector<double> theta) __qpu__ {
+    cudaq::qreg q(3);
+    x(q[0]);
+    ry(theta[0], q[1]);
+    x<cudaq::ctrl>(q[1], q[0]);
+    rx(theta[1], q[2]);
+    if (theta[0] > 1.)
+      h(q[2]);
+  };
+
+  std::vector<std::vector<double>> parameters;
+  for (std::size_t i = 0; i < 9; i++)
+    parameters.push_back({-1.5 + 0.4 * i, 0.3 * i});
+
+  auto results = cudaq::observe_batch(ansatz, H, parameters);
+  ASSERT_EQ(parameters.size(), results.size());
+  for (std::size_t i = 0; i < parameters.size(); i++)
+    EXPECT_NEAR(cudaq::observe(ansatz, H, parameters[i]).exp_val_z(),
+                results[i].exp_val_z(), 1e-5);
+  EXPECT_NEAR(results[5].exp_val_z(),
+              cudaq::observe(ansatz, H, std::vector<double>{0.5, 1.5}), 1e-5);
+}
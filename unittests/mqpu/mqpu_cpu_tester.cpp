@@ -0,0 +1,88 @@
+/*************************************************************** -*- C++ -*- ***
+ * Copyright (c) 2022 - 2023 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ *******************************************************************************/
+#include <cudaq.h>
+#include <cudaq/algorithm.h>
+#include <gtest/gtest.h>
+
+TEST(MQPUCpuTester, checkNumQpus) {
+  auto &platform = cudaq::get_platform();
+  EXPECT_GE(platform.num_qpus(), 1);
+  if (auto envVal = std::getenv("CUDAQ_MQPU_NQPUS"))
+    EXPECT_EQ(platform.num_qpus(), std::stoul(envVal));
+}
+
+TEST(MQPUCpuTester, checkSimple) {
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](double theta) __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    ry(theta, r);
+    x<cudaq::ctrl>(r, q);
+  };
+
+  // Distributed over the QPUs term by term.
+  double result = cudaq::observe(ansatz, h, 0.59);
+  EXPECT_NEAR(result, -1.7487, 1e-3);
+
+  // Sampled with shots on every QPU.
+  EXPECT_NEAR(cudaq::observe(100000, ansatz, h, 0.59), -1.7487, 1e-1);
+
+  // Fewer terms than QPUs.
+  cudaq::spin_op zz = z(0) * z(1);
+  EXPECT_NEAR(cudaq::observe(ansatz, zz, 0.59), -1.0, 1e-6);
+}
+
+TEST(MQPUCpuTester, checkCostBalancedDistribution) {
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](double theta) __qpu__ {
+    cudaq::qubit q, r;
+    x(q);
+    ry(theta, r);
+    x<cudaq::ctrl>(r, q);
+  };
+
+  // Terms of different cost, split into chunks pulled by the QPUs, give the
+  // same result as observing each term on its own.
+  auto H = h * h + 0.5 * x(0) * z(1) + z(0);
+  double expected = 0.0;
+  H.for_each_term([&](cudaq::spin_op &term) {
+    expected += cudaq::observe(ansatz, term, 0.59);
+  });
+  EXPECT_NEAR(cudaq::observe(ansatz, H, 0.59), expected, 1e-6);
+
+  // The identity term is accounted for without running the kernel.
+  EXPECT_NEAR(cudaq::observe(ansatz, 2.5 * cudaq::spin_op(), 0.59), 2.5,
+              1e-12);
+}
+
+TEST(MQPUCpuTester, checkSampleAsync) {
+  auto ghz = [](int n) __qpu__ {
+    cudaq::qreg q(n);
+    h(q[0]);
+    for (int i = 0; i < n - 1; i++)
+      x<cudaq::ctrl>(q[i], q[i + 1]);
+    mz(q);
+  };
+
+  auto &platform = cudaq::get_platform();
+  std::vector<cudaq::async_sample_result> results;
+  for (std::size_t i = 0; i < platform.num_qpus(); i++)
+    results.emplace_back(cudaq::sample_async(i, ghz, 5));
+
+  for (auto &result : results) {
+    auto counts = result.get();
+    EXPECT_EQ(counts.size(), 2);
+    EXPECT_EQ(counts.count("00000") + counts.count("11111"), 1000);
+  }
+}
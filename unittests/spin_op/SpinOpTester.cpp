@@ -9,6 +9,10 @@
 #include <gtest/gtest.h>
 
 #include "cudaq/spin_op.h"
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <set>
 
 using namespace cudaq::spin;
 
@@ -177,4 +181,339 @@ TEST(SpinOpTester, checkGetMatrix) {
     }
     EXPECT_NEAR(sum, -1.74, 1e-2);
   }
-}
\ No newline at end of file
+}
+TEST(SpinOpTester, checkMultiTermMultiplication) {
+  auto a = x(0) + 2.0 * z(1) - y(0) * x(1);
+  auto b = 0.5 * y(0) + z(0) * z(1) + 3.0;
+  auto product = a * b;
+
+  // Compare against the product of the dense matrices, to_matrix() fills
+  // the raw data in row-major order.
+  auto aMat = a.to_matrix(), bMat = b.to_matrix(), got = product.to_matrix();
+  for (std::size_t i = 0; i < 4; i++)
+    for (std::size_t j = 0; j < 4; j++) {
+      std::complex<double> expected = 0.0;
+      for (std::size_t k = 0; k < 4; k++)
+        expected += aMat.data()[i * 4 + k] * bMat.data()[k * 4 + j];
+      EXPECT_NEAR(expected.real(), got.data()[i * 4 + j].real(), 1e-12);
+      EXPECT_NEAR(expected.imag(), got.data()[i * 4 + j].imag(), 1e-12);
+    }
+
+  // Terms that cancel are removed.
+  auto cancelled = (x(0) + y(0)) * (x(0) + y(0));
+  EXPECT_EQ(1, cancelled.n_terms());
+  EXPECT_TRUE(cancelled.is_identity());
+  EXPECT_NEAR(2.0, cancelled.get_term_coefficient(0).real(), 1e-12);
+}
+
+TEST(SpinOpTester, checkCommutation) {
+  EXPECT_TRUE(x(0).commutes_with(x(0)));
+  EXPECT_FALSE(x(0).commutes_with(z(0)));
+  EXPECT_TRUE((x(0) * x(1)).commutes_with(z(0) * z(1)));
+  EXPECT_TRUE(x(0).commutes_with(z(1)));
+  EXPECT_FALSE((x(0) + z(2)).commutes_with(y(2)));
+  EXPECT_TRUE((x(100) * z(3)).commutes_with(z(100) * x(3)));
+  EXPECT_FALSE((x(100) * z(3)).commutes_with(z(100)));
+}
+
+TEST(SpinOpTester, checkManyQubitsAndTerms) {
+  // Terms span more than one 64 bit word.
+  auto op = x(0) * z(70) + y(130);
+  EXPECT_EQ(131, op.n_qubits());
+  EXPECT_EQ(2, op.n_terms());
+  auto bsf = op.get_bsf();
+  EXPECT_TRUE(bsf[0][0]);
+  EXPECT_TRUE(bsf[0][70 + 131]);
+  EXPECT_TRUE(bsf[1][130]);
+  EXPECT_TRUE(bsf[1][130 + 131]);
+  auto coeffs = op.get_coefficients();
+  EXPECT_EQ(op, cudaq::spin_op::from_binary_symplectic(bsf, coeffs));
+
+  // Building a large sum with duplicates merges them through the term
+  // index.
+  cudaq::spin_op h = 0.5 * z(0) * z(1);
+  const std::size_t nQubits = 20;
+  for (std::size_t rep = 0; rep < 2; rep++)
+    for (std::size_t i = 0; i < nQubits; i++)
+      for (std::size_t j = 0; j < nQubits; j++)
+        for (std::size_t k = 0; k < nQubits; k++)
+          h += 0.25 * x(i) * y(j) * z(k);
+  EXPECT_EQ(nQubits, h.n_qubits());
+  std::set<std::string> uniqueTerms;
+  h.for_each_term(
+      [&](cudaq::spin_op &term) { uniqueTerms.insert(term.to_string(false)); });
+  EXPECT_EQ(uniqueTerms.size(), h.n_terms());
+  auto serialized = h.getDataRepresentation();
+  cudaq::spin_op deserialized(serialized, nQubits);
+  EXPECT_EQ(h, deserialized);
+  EXPECT_EQ(h.get_coefficients(), deserialized.get_coefficients());
+
+  auto random = cudaq::spin_op::random(12, 1000);
+  EXPECT_EQ(1000, random.n_terms());
+}
+
+TEST(SpinOpTester, checkQubitWiseCommutingGroups) {
+  auto h = 1.5 + z(0) + z(1) + z(0) * z(1) + x(0) * x(1) + x(0) * y(1) +
+           y(0) * x(1) + x(2) + z(2) * x(0);
+  auto groups = h.group_qubit_wise_commuting();
+
+  std::size_t nTerms = 0;
+  cudaq::spin_op sum = groups[0];
+  for (auto &group : groups) {
+    nTerms += group.n_terms();
+    if (&group != &groups[0])
+      sum += group;
+
+    // Each pair of terms in a group acts with the same pauli, or the
+    // identity, on every qubit.
+    for (std::size_t i = 0; i < group.n_terms(); i++)
+      for (std::size_t j = 0; j < group.n_terms(); j++)
+        group[i].for_each_pauli([&](cudaq::pauli p, std::size_t q) {
+          group[j].for_each_pauli([&](cudaq::pauli r, std::size_t s) {
+            if (q == s && p != cudaq::pauli::I && r != cudaq::pauli::I) {
+              EXPECT_EQ(p, r);
+            }
+          });
+        });
+  }
+  EXPECT_EQ(h.n_terms(), nTerms);
+  EXPECT_EQ(h.n_terms(), sum.n_terms());
+  EXPECT_EQ(0, (h - sum).n_terms());
+  // ZZ-type, XX-type, XY and YX cannot share a basis.
+  EXPECT_EQ(4, groups.size());
+}
+
+TEST(SpinOpTester, checkSparseMatrixAndApply) {
+  auto h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+           .21829 * z(0) - 6.125 * z(1) + 0.5 * x(0) * y(2) * z(1) +
+           0.25 * y(1) * y(2);
+  const std::size_t dim = 8;
+  auto dense = h.to_matrix();
+
+  // Every row of the CSR matrix equals the dense row.
+  auto [values, columns, rowOffsets] = h.to_sparse_matrix();
+  EXPECT_EQ(dim + 1, rowOffsets.size());
+  EXPECT_EQ(values.size(), rowOffsets.back());
+  std::size_t nonZeros = 0;
+  for (std::size_t i = 0; i < dim; i++) {
+    std::vector<std::complex<double>> row(dim, 0.0);
+    for (auto e = rowOffsets[i]; e < rowOffsets[i + 1]; e++) {
+      if (e > rowOffsets[i]) {
+        EXPECT_LT(columns[e - 1], columns[e]);
+      }
+      row[columns[e]] = values[e];
+    }
+    for (std::size_t j = 0; j < dim; j++) {
+      EXPECT_NEAR(std::abs(row[j] - dense.data()[i * dim + j]), 0.0, 1e-12);
+      nonZeros += std::abs(dense.data()[i * dim + j]) > 0.0;
+    }
+  }
+  EXPECT_EQ(nonZeros, values.size());
+
+  // H |v> without forming the matrix.
+  std::vector<std::complex<double>> v(dim);
+  for (std::size_t i = 0; i < dim; i++)
+    v[i] = std::complex<double>(0.1 * i, 1.0 - 0.2 * i);
+  auto hv = h.apply(v);
+  for (std::size_t i = 0; i < dim; i++) {
+    std::complex<double> expected = 0.0;
+    for (std::size_t j = 0; j < dim; j++)
+      expected += dense.data()[i * dim + j] * v[j];
+    EXPECT_NEAR(std::abs(expected - hv[i]), 0.0, 1e-12);
+  }
+  EXPECT_ANY_THROW(h.apply(std::vector<std::complex<double>>(4)));
+
+  // The Lanczos minimal eigenvalue agrees with the dense solver.
+  auto lanczos = cudaq::complex_matrix::minimal_eigenvalue(
+      dim, [&](const std::vector<std::complex<double>> &vec) {
+        return h.apply(vec);
+      });
+  EXPECT_NEAR(dense.minimal_eigenvalue().real(), lanczos.real(), 1e-8);
+
+  // Uncoupled qubits in a tilted field, each contributes -sqrt(1.25) to the
+  // ground energy. The dense minimal_eigenvalue() of the 1024 x 1024 matrix
+  // takes the Lanczos path too.
+  const std::size_t nQubits = 10;
+  cudaq::spin_op field = -1.0 * z(0) - 0.5 * x(0);
+  for (std::size_t q = 1; q < nQubits; q++)
+    field += -1.0 * z(q) - 0.5 * x(q);
+  const double groundEnergy = -std::sqrt(1.25) * nQubits;
+  auto fieldLanczos = cudaq::complex_matrix::minimal_eigenvalue(
+      1 << nQubits, [&](const std::vector<std::complex<double>> &vec) {
+        return field.apply(vec);
+      });
+  EXPECT_NEAR(groundEnergy, fieldLanczos.real(), 1e-8);
+  EXPECT_NEAR(groundEnergy, field.to_matrix().minimal_eigenvalue().real(),
+              1e-8);
+
+  // An unconverged estimate is an error, not a result.
+  EXPECT_ANY_THROW(cudaq::complex_matrix::minimal_eigenvalue(
+      1 << nQubits,
+      [&](const std::vector<std::complex<double>> &vec) {
+        return field.apply(vec);
+      },
+      1e-10, 3));
+}
+
+TEST(SpinOpTester, checkReadWriteBinary) {
+  auto h = 0.5 * x(0) * z(70) + std::complex<double>(0.25, -1.0) * y(130) -
+           2.0 * z(5) * z(6) + 1.5;
+  const std::string packedFile = "checkReadWriteBinary.packed.bin";
+  const std::string doublesFile = "checkReadWriteBinary.doubles.bin";
+  cudaq::binary_spin_op_writer writer;
+  writer.write(h, packedFile);
+  {
+    auto doubles = h.getDataRepresentation();
+    std::ofstream out(doublesFile, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(doubles.data()),
+              doubles.size() * sizeof(double));
+  }
+
+  // Both formats round trip, in one read or in chunks of terms.
+  cudaq::binary_spin_op_reader reader;
+  for (auto &fileName : {packedFile, doublesFile}) {
+    auto read = reader.read(fileName);
+    EXPECT_EQ(h, read);
+    EXPECT_EQ(h.get_coefficients(), read.get_coefficients());
+
+    std::vector<std::size_t> chunkSizes;
+    cudaq::spin_op sum;
+    reader.read_chunks(fileName, 3, [&](cudaq::spin_op &chunk) {
+      EXPECT_EQ(h.n_qubits(), chunk.n_qubits());
+      chunkSizes.push_back(chunk.n_terms());
+      sum += chunk;
+    });
+    EXPECT_EQ(std::vector<std::size_t>({3, 1}), chunkSizes);
+    sum -= cudaq::spin_op();
+    EXPECT_EQ(0, (sum - h).n_terms());
+  }
+
+  {
+    std::ofstream out(packedFile, std::ios::binary | std::ios::app);
+    out << "trailing";
+  }
+  EXPECT_ANY_THROW(reader.read(packedFile));
+  EXPECT_ANY_THROW(reader.read("checkReadWriteBinary.missing.bin"));
+
+  // A term count that is not an integer in range is rejected.
+  for (double termCount : {std::nan(""), -4.0, 1e30, 2.5, 0.0}) {
+    auto doubles = h.getDataRepresentation();
+    doubles.back() = termCount;
+    std::ofstream out(doublesFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(doubles.data()),
+              doubles.size() * sizeof(double));
+    out.close();
+    EXPECT_ANY_THROW(
+        reader.read_chunks(doublesFile, 3, [](cudaq::spin_op &) {}));
+  }
+
+  auto writeDoubles = [&](const std::vector<double> &doubles) {
+    std::ofstream out(doublesFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(doubles.data()),
+              doubles.size() * sizeof(double));
+  };
+
+  // Pauli codes other than 0 to 3 are rejected.
+  auto doubles = h.getDataRepresentation();
+  doubles[0] = 4.0;
+  writeDoubles(doubles);
+  EXPECT_ANY_THROW(reader.read(doublesFile));
+
+  // Zero terms are dropped, as for the same spin_op built in memory.
+  doubles = h.getDataRepresentation();
+  doubles[h.n_qubits()] = 0.0;
+  doubles[h.n_qubits() + 1] = 0.0;
+  writeDoubles(doubles);
+  EXPECT_EQ(h.n_terms() - 1, reader.read(doublesFile).n_terms());
+
+  // X or Z bits above the number of qubits are rejected. The header is 32
+  // bytes, the last X word of the first term is its third word.
+  writer.write(h, packedFile);
+  {
+    std::fstream file(packedFile,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(32 + 2 * 8 + 7);
+    file.put(static_cast<char>(0x80));
+  }
+  EXPECT_ANY_THROW(reader.read(packedFile));
+  std::remove(packedFile.c_str());
+  std::remove(doublesFile.c_str());
+}
+
+TEST(SpinOpTester, checkTermView) {
+  auto h = 0.5 * x(0) * z(70) + std::complex<double>(0.25, -1.0) * y(130) -
+           2.0 * z(5) * z(6) + 1.5;
+  std::size_t count = 0;
+  h.for_each_term_view([&](const cudaq::spin_op::term_view &term) {
+    auto expected = h[term.index()];
+    EXPECT_EQ(count++, term.index());
+    EXPECT_EQ(expected.to_string(false), term.to_string());
+    EXPECT_EQ(expected.get_coefficients()[0], term.get_coefficient());
+    EXPECT_EQ(expected.is_identity(), term.is_identity());
+    EXPECT_EQ(expected, term.to_spin_op());
+    for (std::size_t q = 0; q < h.n_qubits(); q++) {
+      auto bit = (term.x_words()[q / 64] >> (q % 64)) & 1;
+      EXPECT_EQ(bit, expected.get_bsf()[0][q]);
+    }
+  });
+  EXPECT_EQ(h.n_terms(), count);
+  for (std::size_t i = 0; i < h.n_terms(); i++) {
+    auto view = h.get_term_view(i);
+    if (view.get_coefficient() == -2.0) {
+      EXPECT_EQ(cudaq::pauli::Z, view.get_pauli(5));
+      EXPECT_EQ(cudaq::pauli::I, view.get_pauli(7));
+    }
+    if (view.get_coefficient().imag() != 0.0) {
+      EXPECT_EQ(cudaq::pauli::Y, view.get_pauli(130));
+    }
+  }
+}
+
+TEST(SpinOpTester, checkSimplifyAndDistribute) {
+  auto h = 1e-8 * x(0) + 2.0 * z(1) * z(2) * z(3) + 0.5 * y(4) + 3.0;
+  auto simplified = h;
+  simplified.simplify(1e-6);
+  EXPECT_EQ(3, simplified.n_terms());
+  EXPECT_EQ(0, (simplified - (2.0 * z(1) * z(2) * z(3) + 0.5 * y(4) + 3.0))
+                   .n_terms());
+  EXPECT_EQ(4, h.simplify().n_terms());
+
+  // Squaring a random operator gives the same result on one or more
+  // threads, the product of a sum of Paulis with itself has a real
+  // constant term equal to the sum of the squared coefficients.
+  auto random = cudaq::spin_op::random(10, 300);
+  auto squared = random * random;
+  EXPECT_EQ(squared, squared.simplify());
+  double constant = 0.0;
+  squared.for_each_term_view([&](const cudaq::spin_op::term_view &term) {
+    if (term.is_identity())
+      constant = term.get_coefficient().real();
+  });
+  EXPECT_NEAR(300.0, constant, 1e-9);
+
+  // Every term lands in exactly one part, the parts have about equal cost.
+  auto hCosts = h.get_term_costs();
+  std::multiset<std::size_t> sortedCosts(hCosts.begin(), hCosts.end());
+  EXPECT_EQ(std::multiset<std::size_t>({0, 2, 2, 4}), sortedCosts);
+  auto costs = random.get_term_costs();
+  auto maxCost = *std::max_element(costs.begin(), costs.end());
+  auto parts = random.distribute(7);
+  EXPECT_EQ(7, parts.size());
+  cudaq::spin_op sum = parts[0];
+  std::size_t nTerms = 0;
+  std::vector<std::size_t> loads;
+  for (std::size_t p = 0; p < parts.size(); p++) {
+    if (p > 0)
+      sum += parts[p];
+    nTerms += parts[p].n_terms();
+    auto partCosts = parts[p].get_term_costs();
+    loads.push_back(std::accumulate(partCosts.begin(), partCosts.end(), 0ul));
+  }
+  EXPECT_LE(*std::max_element(loads.begin(), loads.end()) -
+                *std::min_element(loads.begin(), loads.end()),
+            maxCost);
+  EXPECT_EQ(random.n_terms(), nTerms);
+  EXPECT_EQ(0, (sum - random).n_terms());
+  EXPECT_EQ(4, h.distribute(10).size());
+  EXPECT_ANY_THROW(h.distribute(0));
+}